@@ -0,0 +1,423 @@
+/*
+	Copyright 2026 Daniel T. Borelli <danieltborelli@gmail.com>
+
+	This file is part of xrunit.
+
+	xrunit is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	xrunit is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with xrunit.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "config.h"
+#include "status.h"
+#include "history.h"
+#include "procstat.h"
+#include "registry.h"
+#include "system.h"
+#include "fixture.h"
+
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+
+/*
+ * Refresh benchmark over a synthetic runit tree:
+ *
+ *   xrunit-bench [N...]          default: 10 100 1000 10000 services
+ *   xrunit-bench --fixture DIR N create the tree and keep it
+ *
+ * Only the data path is measured, the browsers need a display.
+ */
+
+#define BENCH_RUNS_TOTAL 100000
+#define BENCH_RUNS_MIN 3
+#define BENCH_RUNS_MAX 200
+
+#define BENCH_TRACE_ID "events/raw_syscalls/sys_enter/id"
+
+struct BenchPhase
+{
+	char const* name;
+	void (*run)(void);
+};
+
+static std::string benchSvDir;
+
+static std::string benchRunDir;
+
+static std::string benchEditDir;
+
+static StatusSnapshot benchSnapshot;
+
+static Fl_Text_Buffer* benchBuffer = NULL;
+
+static unsigned long benchAllocs = 0;
+
+static int benchSyscallFd = -1;
+
+/* Cost of reading the syscall counter itself. */
+static unsigned long long benchSyscallSelf = 0;
+
+
+/*
+ * Every allocation of the process, operator new included,
+ * goes through these: glibc allows replacing malloc.
+ */
+extern "C"
+{
+	void* __libc_malloc(size_t sz);
+	void* __libc_calloc(size_t n, size_t sz);
+	void* __libc_realloc(void* ptr, size_t sz);
+
+	void* malloc(size_t sz) __THROW
+	{
+		++benchAllocs;
+		return __libc_malloc(sz);
+	}
+
+	void* calloc(size_t n, size_t sz) __THROW
+	{
+		++benchAllocs;
+		return __libc_calloc(n, sz);
+	}
+
+	void* realloc(void* ptr, size_t sz) __THROW
+	{
+		++benchAllocs;
+		return __libc_realloc(ptr, sz);
+	}
+}
+
+
+static double BenchNow(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (double)ts.tv_sec * 1e3 + (double)ts.tv_nsec / 1e6;
+}
+
+
+/* All the syscalls through perf, it needs the tracefs id and perf_event_paranoid. */
+static void BenchSyscallOpen(void)
+{
+	static char const* const traceDir[] = {
+		"/sys/kernel/tracing/",
+		"/sys/kernel/debug/tracing/",
+	};
+
+	for (char const* const dir : traceDir)
+	{
+		std::string const path = std::string(dir) + BENCH_TRACE_ID;
+
+		FILE* file = fopen(path.c_str(), "r");
+
+		if (file == NULL)
+		{
+			continue;
+		}
+
+		unsigned long long id = 0;
+
+		bool const ok = (fscanf(file, "%llu", &id) == 1);
+
+		fclose(file);
+
+		if (!ok)
+		{
+			continue;
+		}
+
+		struct perf_event_attr attr;
+
+		memset(&attr, 0, sizeof(attr));
+		attr.type = PERF_TYPE_TRACEPOINT;
+		attr.size = sizeof(attr);
+		attr.config = id;
+
+		benchSyscallFd = (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, PERF_FLAG_FD_CLOEXEC);
+
+		if (benchSyscallFd != -1)
+		{
+			return;
+		}
+	}
+}
+
+
+/* Without perf only read(2) and write(2) like calls are known: /proc/self/io */
+static unsigned long long BenchSyscalls(void)
+{
+	unsigned long long count = 0;
+
+	if (benchSyscallFd != -1)
+	{
+		if (read(benchSyscallFd, &count, sizeof(count)) != sizeof(count))
+		{
+			count = 0;
+		}
+
+		return count;
+	}
+
+	FILE* file = fopen("/proc/self/io", "r");
+
+	if (file == NULL)
+	{
+		return 0;
+	}
+
+	char line[128];
+
+	while (fgets(line, sizeof(line), file))
+	{
+		unsigned long long value = 0;
+
+		if (sscanf(line, "syscr: %llu", &value) == 1 || sscanf(line, "syscw: %llu", &value) == 1)
+		{
+			count += value;
+		}
+	}
+
+	fclose(file);
+
+	return count;
+}
+
+
+/* FillBrowserEnable without the browser: scan, format and registry. */
+static void BenchStatus(void)
+{
+	if (!StatusScan(benchRunDir.c_str(), benchSnapshot))
+	{
+		STOP("StatusScan %s: %s", benchRunDir.c_str(), strerror(errno));
+	}
+
+	time_t const now = time(NULL);
+
+	std::string line;
+
+	for (ServiceStatus const& st : benchSnapshot)
+	{
+		StatusFormat(st, now, line);
+	}
+
+	RegistryUpdateStatus(benchSnapshot);
+}
+
+
+/* FillBrowserList without the browser. */
+static void BenchRegistry(void)
+{
+	RegistryScan(benchSvDir.c_str(), benchRunDir.c_str());
+}
+
+
+static void BenchListCb(UNUSED char const* path)
+{
+}
+
+
+static void BenchList(void)
+{
+	ListDirectories(benchSvDir.c_str(), BenchListCb);
+}
+
+
+/* The same reads and stats that EditLoad does: only 'run', the other tabs load when shown. */
+static void BenchEditLoad(void)
+{
+	static char const* const files[] = {
+		"run", "log/run", "log/conf", "finish", "conf", "check",
+	};
+
+	std::string const run = benchEditDir + files[0];
+
+	FileAccessOk(run.c_str(), false);
+	isFileTypeELF(run.c_str(), false);
+	benchBuffer->loadfile(run.c_str());
+	GetModifyFileTime(run.c_str());
+
+	// The tab labels are colored by the size of each file.
+	for (size_t i = 0; i < sizeof(files) / sizeof(files[0]); ++i)
+	{
+		std::string const path = benchEditDir + files[i];
+
+		struct stat st;
+
+		stat(path.c_str(), &st);
+	}
+}
+
+
+static BenchPhase const benchPhases[] = {
+	{ "status scan", BenchStatus },
+	{ "registry scan", BenchRegistry },
+	{ "list dirs", BenchList },
+	{ "edit load", BenchEditLoad },
+};
+
+
+static void BenchRun(BenchPhase const& phase, int const n)
+{
+	int runs = BENCH_RUNS_TOTAL / n;
+
+	runs = (runs < BENCH_RUNS_MIN) ? BENCH_RUNS_MIN : ((runs > BENCH_RUNS_MAX) ? BENCH_RUNS_MAX : runs);
+
+	std::vector<double> times;
+
+	times.reserve(runs);
+
+	/* warm up the dentry cache */
+	phase.run();
+
+	unsigned long long const syscalls = BenchSyscalls();
+	unsigned long const allocs = benchAllocs;
+
+	for (int i = 0; i < runs; ++i)
+	{
+		double const start = BenchNow();
+		phase.run();
+		times.push_back(BenchNow() - start);
+	}
+
+	unsigned long const allocsEnd = benchAllocs;
+	unsigned long long const syscallsEnd = BenchSyscalls();
+
+	std::sort(times.begin(), times.end());
+
+	printf("%8d  %-14s %10.3f %10.3f %10.3f %10.1f %10.1f\n", n, phase.name,
+		times[runs / 2], times[0], times[runs - 1],
+		(double)(allocsEnd - allocs) / runs,
+		(double)(syscallsEnd - syscalls - benchSyscallSelf) / runs);
+}
+
+
+static bool BenchTempRoot(std::string& root)
+{
+	char const* tmp = secure_getenv("TMPDIR");
+
+	root = (tmp != NULL) ? tmp : "/tmp";
+	root += "/xrunit-bench.XXXXXX";
+
+	errno = 0;
+
+	if (mkdtemp(&root[0]) == NULL)
+	{
+		fprintf(stderr, "xrunit-bench: mkdtemp %s: %s\n", root.c_str(), strerror(errno));
+		return false;
+	}
+
+	return true;
+}
+
+
+static bool BenchServices(int const n)
+{
+	std::string root;
+
+	if (!BenchTempRoot(root))
+	{
+		return false;
+	}
+
+	if (!FixtureCreate(root.c_str(), n))
+	{
+		FixtureRemove(root.c_str());
+		return false;
+	}
+
+	benchSvDir = root + "/sv";
+	benchRunDir = root + "/service";
+	benchEditDir = benchSvDir + "/service-00000/";
+
+	for (BenchPhase const& phase : benchPhases)
+	{
+		BenchRun(phase, n);
+	}
+
+	FixtureRemove(root.c_str());
+
+	return true;
+}
+
+
+static int BenchFixture(char const* const root, int const n)
+{
+	if (!MakeDir(root, false) && errno != EEXIST)
+	{
+		fprintf(stderr, "xrunit-bench: %s: %s\n", root, strerror(errno));
+		return EXIT_FAILURE;
+	}
+
+	if (!FixtureCreate(root, n))
+	{
+		return EXIT_FAILURE;
+	}
+
+	printf("SVDIR=%s/sv SVRUNDIR=%s/service\n", root, root);
+
+	return EXIT_SUCCESS;
+}
+
+
+int main(int argc, char* argv[])
+{
+	if (argc == 4 && strcmp(argv[1], "--fixture") == 0)
+	{
+		return BenchFixture(argv[2], atoi(argv[3]));
+	}
+
+	std::vector<int> sizes;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		int const n = atoi(argv[i]);
+
+		if (n <= 0)
+		{
+			fprintf(stderr, "Usage: xrunit-bench [N...] | --fixture DIR N\n");
+			return EXIT_FAILURE;
+		}
+
+		sizes.push_back(n);
+	}
+
+	if (sizes.empty())
+	{
+		sizes = { 10, 100, 1000, 10000 };
+	}
+
+	benchBuffer = new Fl_Text_Buffer;
+
+	BenchSyscallOpen();
+
+	/* the counter reads itself: open, read, close or one read */
+	unsigned long long const self = BenchSyscalls();
+	benchSyscallSelf = BenchSyscalls() - self;
+
+	printf("%s\nsyscalls: %s\n\n", TITLE, (benchSyscallFd != -1)
+		? "all (perf raw_syscalls:sys_enter)"
+		: "read and write only (/proc/self/io)");
+
+	printf("%8s  %-14s %10s %10s %10s %10s %10s\n", "services", "phase",
+		"median ms", "min ms", "max ms", "allocs", "syscalls");
+
+	for (int const n : sizes)
+	{
+		if (!BenchServices(n))
+		{
+			return EXIT_FAILURE;
+		}
+	}
+
+	delete benchBuffer;
+
+	return EXIT_SUCCESS;
+}
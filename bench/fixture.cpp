@@ -0,0 +1,191 @@
+/*
+	Copyright 2026 Daniel T. Borelli <danieltborelli@gmail.com>
+
+	This file is part of xrunit.
+
+	xrunit is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	xrunit is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with xrunit.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "config.h"
+#include "status.h"
+#include "system.h"
+#include "fixture.h"
+
+/* TAI64 label of the unix epoch, see status.cpp */
+#define FIXTURE_TAI64_UNIX_EPOCH 4611686018427387914ULL
+
+/* 3 of 4 services are linked in SV_RUN_DIR */
+#define FIXTURE_UNLINKED 4
+
+#define FIXTURE_DOWN 7
+
+#define FIXTURE_FINISH 13
+
+
+static bool FixtureWrite(std::string const& path, char const* const data, size_t const sz)
+{
+	errno = 0;
+
+	int const fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+
+	if (fd == -1)
+	{
+		fprintf(stderr, "fixture: %s: %s\n", path.c_str(), strerror(errno));
+		return false;
+	}
+
+	bool const ok = (write(fd, data, sz) == (ssize_t)sz);
+
+	close(fd);
+
+	return ok;
+}
+
+
+static bool FixtureText(std::string const& path, char const* const text)
+{
+	return FixtureWrite(path, text, strlen(text));
+}
+
+
+/* Record with the same layout that runsv writes, see StatusReadSupervise. */
+static bool FixtureSupervise(std::string const& dir, int const i, int const state)
+{
+	std::string path = dir + "/supervise";
+
+	if (!MakeDir(path.c_str(), false))
+	{
+		return false;
+	}
+
+	unsigned char rec[STATUS_RECORD_SZ] = {0};
+
+	unsigned long long const tai = FIXTURE_TAI64_UNIX_EPOCH + (unsigned long long)(time(NULL) - i * 60);
+
+	for (int b = 0; b < 8; ++b)
+	{
+		rec[b] = (unsigned char)(tai >> (56 - 8 * b));
+	}
+
+	pid_t const pid = (state == STATE_DOWN) ? 0 : 1000 + i;
+
+	rec[12] = (unsigned char)pid;
+	rec[13] = (unsigned char)(pid >> 8);
+	rec[14] = (unsigned char)(pid >> 16);
+	rec[15] = (unsigned char)(pid >> 24);
+	rec[17] = (state == STATE_DOWN) ? 'd' : 'u';
+	rec[19] = (unsigned char)state;
+
+	return FixtureWrite(path + "/status", (char const*)rec, sizeof(rec))
+		&& FixtureText(path + "/ok", "")
+		&& FixtureText(path + "/control", "");
+}
+
+
+static bool FixtureService(std::string const& svDir, std::string const& runDir, int const i)
+{
+	char name[32];
+
+	snprintf(name, sizeof(name), "service-%05d", i);
+
+	std::string const dir = svDir + "/" + name;
+	std::string const log = dir + "/log";
+
+	if (!MakeDir(dir.c_str(), false) || !MakeDir(log.c_str(), false))
+	{
+		fprintf(stderr, "fixture: %s: %s\n", dir.c_str(), strerror(errno));
+		return false;
+	}
+
+	bool const down = (i % FIXTURE_DOWN == 0);
+
+	int const state = down ? STATE_DOWN : ((i % FIXTURE_FINISH == 0) ? STATE_FINISH : STATE_RUN);
+
+	bool ok = FixtureText(dir + "/run", "#!/bin/sh\nexec 2>&1\nexec sleep infinity\n")
+		&& FixtureText(dir + "/conf", "OPTS=\"--foreground\"\n")
+		&& FixtureText(log + "/run", "#!/bin/sh\nexec svlogd -tt ./main\n")
+		&& FixtureSupervise(dir, i, state)
+		&& FixtureSupervise(log, i, down ? STATE_DOWN : STATE_RUN);
+
+	if (ok && (i % 2 == 0))
+	{
+		ok = FixtureText(dir + "/finish", "#!/bin/sh\nexit 0\n");
+	}
+
+	if (ok && down)
+	{
+		ok = FixtureText(dir + "/down", "") && FixtureText(log + "/down", "");
+	}
+
+	if (ok && (i % FIXTURE_UNLINKED != 0))
+	{
+		std::string const target = std::string("../sv/") + name;
+		std::string const link = runDir + "/" + name;
+
+		errno = 0;
+
+		if (symlink(target.c_str(), link.c_str()) == -1)
+		{
+			fprintf(stderr, "fixture: %s: %s\n", link.c_str(), strerror(errno));
+			ok = false;
+		}
+	}
+
+	return ok;
+}
+
+
+bool FixtureCreate(char const* const root, int const n)
+{
+	ASSERT_DBG_STRING(root);
+	ASSERT_DBG(n > 0);
+
+	std::string const svDir = std::string(root) + "/sv";
+	std::string const runDir = std::string(root) + "/service";
+
+	if (!MakeDir(svDir.c_str(), false) || !MakeDir(runDir.c_str(), false))
+	{
+		fprintf(stderr, "fixture: %s: %s\n", root, strerror(errno));
+		return false;
+	}
+
+	for (int i = 0; i < n; ++i)
+	{
+		if (!FixtureService(svDir, runDir, i))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+
+static int FixtureRemoveCb(char const* path, UNUSED const struct stat* sb, UNUSED int flag, UNUSED struct FTW* ftw)
+{
+	if (remove(path) == -1)
+	{
+		fprintf(stderr, "fixture: remove %s: %s\n", path, strerror(errno));
+	}
+
+	return 0;
+}
+
+
+void FixtureRemove(char const* const root)
+{
+	ASSERT_DBG_STRING(root);
+
+	/* FTW_PHYS: do not follow the SV_RUN_DIR symlinks. */
+	nftw(root, FixtureRemoveCb, 20, FTW_DEPTH | FTW_PHYS);
+}
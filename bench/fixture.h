@@ -0,0 +1,37 @@
+/*
+	Copyright 2026 Daniel T. Borelli <danieltborelli@gmail.com>
+
+	This file is part of xrunit.
+
+	xrunit is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	xrunit is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with xrunit.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef FIXTURE_H_INCLUDE
+#define FIXTURE_H_INCLUDE
+
+/*
+ * Synthetic runit tree for the benchmark:
+ *
+ *   root/sv/NAME           SV_DIR     (SVDIR)
+ *   root/service/NAME      SV_RUN_DIR (SVRUNDIR), symlink to ../sv/NAME
+ *
+ * 'supervise/ok' is a regular file, the open(2) done by the
+ * status reader succeeds as if runsv were running.
+ */
+
+bool FixtureCreate(char const* const root, int const n);
+
+void FixtureRemove(char const* const root);
+
+#endif
@@ -0,0 +1,477 @@
+/*
+	Copyright 2026 Daniel T. Borelli <danieltborelli@gmail.com>
+
+	This file is part of xrunit.
+
+	xrunit is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	xrunit is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with xrunit.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "config.h"
+#include "status.h"
+#include "control.h"
+#include "client.h"
+#include "deps.h"
+#include "cli.h"
+
+enum {
+	CLI_TEXT,
+	CLI_TSV,
+	CLI_JSON,
+};
+
+/* Like sv(8), the exit code is the number of failed services. */
+#define CLI_EXIT_MAX 99
+
+static char const* cliSvDir = SV_DIR;
+
+static char const* cliRunDir = SV_RUN_DIR;
+
+static char const* cliSocket = NULL;
+
+
+static void CliUsage(FILE* out)
+{
+	fprintf(out, "%s\n\n"
+		"Usage:\n"
+		"  xrunit                           graphical interface\n"
+		"  xrunit --status [--json|--tsv]   status of the services in %s\n"
+		"  xrunit --ACTION service...       send ACTION to the services\n"
+		"  xrunit --start|--stop [--timeout SECONDS] service...\n"
+		"                                   start with what they need, or stop with what\n"
+		"                                   needs them, in waves by the 'deps' files of %s\n"
+		"  xrunit --daemon                  xrunitd, serves the clients of %s\n"
+		"  xrunit --version\n\n"
+		"ACTION: up, down, restart, once, pause, cont, hup, alarm,\n"
+		"        interrupt, quit, 1, 2, term, kill, exit\n", TITLE, cliRunDir, cliSvDir, XRUNITD_SOCKET);
+}
+
+
+bool CliIsCommand(int const argc, char* argv[])
+{
+	if (argc < 2 || strncmp(argv[1], "--", 2) != 0)
+	{
+		return false;
+	}
+
+	char const* const opt = argv[1] + 2;
+
+	return strcmp(opt, "status") == 0
+		|| strcmp(opt, "help") == 0
+		|| strcmp(opt, "start") == 0
+		|| strcmp(opt, "stop") == 0
+		|| ControlCommand(opt) != NULL;
+}
+
+
+static void CliPutJsonString(char const* str)
+{
+	putchar('"');
+
+	for (; *str; ++str)
+	{
+		unsigned char const c = *str;
+
+		if (c == '"' || c == '\\')
+		{
+			printf("\\%c", c);
+		}
+		else if (c < 0x20)
+		{
+			printf("\\u%04x", c);
+		}
+		else
+		{
+			putchar(c);
+		}
+	}
+
+	putchar('"');
+}
+
+
+static void CliPrintJson(SuperviseStatus const& st, time_t const now)
+{
+	printf("{\"state\":\"%s\"", StatusStateName(st.state));
+
+	if (st.state == STATE_FAIL)
+	{
+		printf(",\"error\":");
+		CliPutJsonString(ControlError(st.error));
+		putchar('}');
+		return;
+	}
+
+	printf(",\"pid\":%d,\"since\":%ld,\"uptime\":%ld"
+		",\"normally_up\":%s,\"want\":\"%s\",\"paused\":%s}",
+		(int)st.pid, (long)st.since, (long)(now - st.since),
+		st.normallyUp ? "true" : "false",
+		st.wantUp ? "up" : (st.wantDown ? "down" : ""),
+		st.paused ? "true" : "false");
+}
+
+
+static void CliPrintTsv(SuperviseStatus const& st, time_t const now)
+{
+	if (st.state == STATE_FAIL)
+	{
+		printf("\t%s\t\t\t\t\t", StatusStateName(st.state));
+		return;
+	}
+
+	printf("\t%s\t%d\t%ld\t%s\t%s\t%d", StatusStateName(st.state), (int)st.pid,
+		(long)(now - st.since), st.normallyUp ? "up" : "down",
+		st.wantUp ? "up" : (st.wantDown ? "down" : ""), st.paused ? 1 : 0);
+}
+
+
+/* The first batch of xrunitd is the whole snapshot. */
+static bool CliScan(StatusSnapshot& snap)
+{
+	if (cliSocket == NULL)
+	{
+		return StatusScan(cliRunDir, snap);
+	}
+
+	int const fd = ClientConnect(cliSocket);
+
+	if (fd == -1)
+	{
+		return false;
+	}
+
+	ClientState cs;
+	cs.reset = false;
+	cs.batches = 0;
+
+	bool const ok = ClientWait(fd, cs, snap, 0);
+
+	int const error = errno;
+	close(fd);
+	errno = error;
+
+	return ok;
+}
+
+
+static int CliStatus(int const format)
+{
+	StatusSnapshot snap;
+
+	if (!CliScan(snap))
+	{
+		fprintf(stderr, "xrunit: %s: %s\n", (cliSocket != NULL) ? cliSocket : cliRunDir, strerror(errno));
+		return EXIT_FAILURE;
+	}
+
+	time_t const now = time(NULL);
+
+	std::string line;
+
+	bool first = true;
+
+	if (format == CLI_JSON)
+	{
+		putchar('[');
+	}
+	else if (format == CLI_TSV)
+	{
+		printf("name\tstate\tpid\tuptime\tnormally\twant\tpaused"
+			"\tlog_state\tlog_pid\tlog_uptime\tlog_normally\tlog_want\tlog_paused\n");
+	}
+
+	for (ServiceStatus const& st : snap)
+	{
+#ifdef IGNORE_RUN_SERVICES
+		if (FindIgnoreService(st.path.c_str()))
+		{
+			continue;
+		}
+#endif
+		switch (format)
+		{
+		case CLI_TEXT:
+			StatusFormat(st, now, line);
+			line.replace(line.find('\t'), 1, ": ");
+			puts(line.c_str());
+			break;
+
+		case CLI_TSV:
+			fputs(st.name.c_str(), stdout);
+			CliPrintTsv(st.srv, now);
+
+			if (st.hasLog)
+			{
+				CliPrintTsv(st.log, now);
+			}
+			else
+			{
+				fputs("\t\t\t\t\t\t", stdout);
+			}
+
+			putchar('\n');
+			break;
+
+		case CLI_JSON:
+			printf("%s{\"name\":", first ? "" : ",");
+			CliPutJsonString(st.name.c_str());
+			printf(",\"service\":");
+			CliPrintJson(st.srv, now);
+
+			if (st.hasLog)
+			{
+				printf(",\"log\":");
+				CliPrintJson(st.log, now);
+			}
+
+			putchar('}');
+			break;
+		}
+
+		first = false;
+	}
+
+	if (format == CLI_JSON)
+	{
+		puts("]");
+	}
+
+	return EXIT_SUCCESS;
+}
+
+
+/* xrunitd only takes 'name' or 'name/log' of its run directory. */
+static int CliControlDaemon(char const* const action, int const argc, char* argv[])
+{
+	int const fd = ClientConnect(cliSocket);
+
+	if (fd == -1)
+	{
+		fprintf(stderr, "xrunit: %s: %s\n", cliSocket, strerror(errno));
+		return EXIT_FAILURE;
+	}
+
+	size_t const len = strlen(cliRunDir);
+
+	int sent = 0;
+
+	for (int i = 0; i < argc; ++i)
+	{
+		char const* service = argv[i];
+
+		if (strncmp(service, cliRunDir, len) == 0 && service[len] == '/')
+		{
+			service += len + 1;
+		}
+
+		if (!ClientSend(fd, i, action, service))
+		{
+			break;
+		}
+
+		++sent;
+	}
+
+	ClientState cs;
+	cs.reset = false;
+	cs.batches = 0;
+
+	StatusSnapshot snap;
+
+	if (sent < argc || !ClientWait(fd, cs, snap, sent))
+	{
+		fprintf(stderr, "xrunit: %s: %s\n", cliSocket, strerror(errno));
+		close(fd);
+		return EXIT_FAILURE;
+	}
+
+	close(fd);
+
+	int failed = 0;
+
+	for (ClientReply const& reply : cs.replies)
+	{
+		if (reply.error != 0 && reply.id >= 0 && reply.id < argc)
+		{
+			fprintf(stderr, "fail: %s: %s\n", argv[reply.id], ControlError(reply.error));
+			++failed;
+		}
+	}
+
+	return (failed > CLI_EXIT_MAX) ? CLI_EXIT_MAX : failed;
+}
+
+
+static int CliControl(char const* const action, int const argc, char* argv[])
+{
+	char const* const cmd = ControlCommand(action);
+
+	ASSERT_DBG(cmd);
+
+	if (argc == 0)
+	{
+		CliUsage(stderr);
+		return EXIT_FAILURE;
+	}
+
+	if (cliSocket != NULL)
+	{
+		return CliControlDaemon(action, argc, argv);
+	}
+
+	int failed = 0;
+
+	for (int i = 0; i < argc; ++i)
+	{
+		std::string dir;
+
+		if (argv[i][0] == '/')
+		{
+			dir = argv[i];
+		}
+		else
+		{
+			dir = cliRunDir;
+			dir += "/";
+			dir += argv[i];
+		}
+
+		int const error = ControlSend(dir.c_str(), cmd);
+
+		if (error != 0)
+		{
+			fprintf(stderr, "fail: %s: %s\n", argv[i], ControlError(error));
+			++failed;
+		}
+	}
+
+	return (failed > CLI_EXIT_MAX) ? CLI_EXIT_MAX : failed;
+}
+
+
+/* Each wave waits for the previous one, the exit code is the number of services not ready. */
+static int CliDeps(bool const up, int argc, char* argv[])
+{
+	int timeout = DEPS_TIMEOUT;
+
+	if (argc >= 2 && strcmp(argv[0], "--timeout") == 0)
+	{
+		timeout = atoi(argv[1]);
+		argc -= 2;
+		argv += 2;
+	}
+
+	if (argc == 0 || timeout <= 0)
+	{
+		CliUsage(stderr);
+		return EXIT_FAILURE;
+	}
+
+	// xrunitd does not run the 'check' of the services for its clients.
+	if (cliSocket != NULL)
+	{
+		fprintf(stderr, "xrunit: --%s needs administrator permissions\n", up ? "start" : "stop");
+		return EXIT_FAILURE;
+	}
+
+	std::vector<std::string> const services(argv, argv + argc);
+
+	DepsRun run;
+	std::string error;
+
+	if (!DepsStart(run, cliSvDir, cliRunDir, services, up, timeout, error))
+	{
+		fprintf(stderr, "xrunit: %s\n", error.c_str());
+		return EXIT_FAILURE;
+	}
+
+	int state = DEPS_RUNNING;
+
+	for (;;)
+	{
+		if (!run.message.empty())
+		{
+			puts(run.message.c_str());
+			fflush(stdout);
+		}
+
+		if (state != DEPS_RUNNING)
+		{
+			break;
+		}
+
+		usleep(DEPS_POLL * 1e6);
+
+		state = DepsStep(run);
+	}
+
+	for (std::string const& name : run.failed)
+	{
+		fprintf(stderr, "fail: %s\n", name.c_str());
+	}
+
+	int const failed = run.failed.size();
+
+	return (failed > CLI_EXIT_MAX) ? CLI_EXIT_MAX : failed;
+}
+
+
+int CliRun(int const argc, char* argv[], char const* const svDir, char const* const runDir,
+		char const* const socketPath)
+{
+	ASSERT_DBG(CliIsCommand(argc, argv));
+	ASSERT_DBG_STRING(svDir);
+	ASSERT_DBG_STRING(runDir);
+
+	cliSvDir = svDir;
+	cliRunDir = runDir;
+	cliSocket = socketPath;
+
+	char const* const opt = argv[1] + 2;
+
+	if (strcmp(opt, "help") == 0)
+	{
+		CliUsage(stdout);
+		return EXIT_SUCCESS;
+	}
+
+	if (strcmp(opt, "status") == 0)
+	{
+		int format = CLI_TEXT;
+
+		for (int i = 2; i < argc; ++i)
+		{
+			if (strcmp(argv[i], "--json") == 0)
+			{
+				format = CLI_JSON;
+			}
+			else if (strcmp(argv[i], "--tsv") == 0)
+			{
+				format = CLI_TSV;
+			}
+			else
+			{
+				CliUsage(stderr);
+				return EXIT_FAILURE;
+			}
+		}
+
+		return CliStatus(format);
+	}
+
+	if (strcmp(opt, "start") == 0 || strcmp(opt, "stop") == 0)
+	{
+		return CliDeps(strcmp(opt, "start") == 0, argc - 2, argv + 2);
+	}
+
+	return CliControl(opt, argc - 2, argv + 2);
+}
@@ -0,0 +1,38 @@
+/*
+	Copyright 2026 Daniel T. Borelli <danieltborelli@gmail.com>
+
+	This file is part of xrunit.
+
+	xrunit is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	xrunit is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with xrunit.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef CLI_H_INCLUDE
+#define CLI_H_INCLUDE
+
+/*
+ * Headless mode, without fltk or X11:
+ *
+ *   xrunit --status [--json|--tsv]
+ *   xrunit --up|--down|--restart|... service...
+ *   xrunit --start|--stop [--timeout SECONDS] service...
+ *
+ * With 'socketPath' both go through xrunitd.
+ */
+
+bool CliIsCommand(int const argc, char* argv[]);
+
+int CliRun(int const argc, char* argv[], char const* const svDir, char const* const runDir,
+		char const* const socketPath);
+
+#endif
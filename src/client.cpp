@@ -0,0 +1,262 @@
+/*
+	Copyright 2026 Daniel T. Borelli <danieltborelli@gmail.com>
+
+	This file is part of xrunit.
+
+	xrunit is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	xrunit is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with xrunit.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "config.h"
+#include "status.h"
+#include "daemon.h"
+#include "client.h"
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <poll.h>
+
+/* Milliseconds that ClientWait waits for the daemon. */
+#define CLIENT_WAIT_MAX 5000
+
+
+int ClientConnect(char const* const path)
+{
+	ASSERT_DBG_STRING(path);
+
+	struct sockaddr_un addr;
+
+	memset(&addr, 0, sizeof(addr));
+
+	addr.sun_family = AF_UNIX;
+
+	if (strlen(path) >= sizeof(addr.sun_path))
+	{
+		errno = ENAMETOOLONG;
+		return -1;
+	}
+
+	strcpy(addr.sun_path, path);
+
+	int const fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+
+	if (fd == -1)
+	{
+		return -1;
+	}
+
+	if (connect(fd, (struct sockaddr*)&addr, sizeof(addr)) == -1)
+	{
+		int const error = errno;
+		close(fd);
+		errno = error;
+		return -1;
+	}
+
+	return fd;
+}
+
+
+/* A few bytes, the socket buffer takes them at once. */
+bool ClientSend(int const fd, int const id, char const* const action, char const* const service)
+{
+	ASSERT_DBG_STRING(action);
+	ASSERT_DBG_STRING(service);
+
+	char str[DAEMON_LINE_MAX];
+
+	int const len = snprintf(str, sizeof(str), "C\t%d\t%s\t%s\n", id, action, service);
+
+	if (len <= 0 || len >= (int)sizeof(str))
+	{
+		errno = ENAMETOOLONG;
+		return false;
+	}
+
+	return send(fd, str, len, MSG_NOSIGNAL) == len;
+}
+
+
+static void ClientParseSupervise(char** save, SuperviseStatus& st)
+{
+	char const* field[5];
+
+	for (int i = 0; i < 5; ++i)
+	{
+		field[i] = strtok_r(NULL, "\t", save);
+		field[i] = (field[i] != NULL) ? field[i] : "0";
+	}
+
+	int const flags = atoi(field[4]);
+
+	st.since = (time_t)atol(field[0]);
+	st.pid = (pid_t)atoi(field[1]);
+	st.state = atoi(field[2]);
+	st.error = atoi(field[3]);
+	st.paused = (flags & DAEMON_FLAG_PAUSED) != 0;
+	st.wantUp = (flags & DAEMON_FLAG_WANT_UP) != 0;
+	st.wantDown = (flags & DAEMON_FLAG_WANT_DOWN) != 0;
+	st.gotTerm = (flags & DAEMON_FLAG_GOT_TERM) != 0;
+	st.normallyUp = (flags & DAEMON_FLAG_NORMALLY_UP) != 0;
+
+	if (st.state < STATE_DOWN || st.state >= STATE_MAX)
+	{
+		st.state = STATE_FAIL;
+	}
+}
+
+
+static StatusSnapshot::iterator ClientFind(StatusSnapshot& snap, char const* const name)
+{
+	return std::lower_bound(snap.begin(), snap.end(), name,
+		[](ServiceStatus const& st, char const* const key) { return strcmp(st.name.c_str(), key) < 0; });
+}
+
+
+static void ClientParse(ClientState& cs, StatusSnapshot& snap, char* line)
+{
+	char* save = NULL;
+
+	char const* const type = strtok_r(line, "\t", &save);
+
+	if (type == NULL)
+	{
+		return;
+	}
+
+	switch (type[0])
+	{
+		case 'S':
+		{
+			char const* const name = strtok_r(NULL, "\t", &save);
+			char const* const path = strtok_r(NULL, "\t", &save);
+			char const* const hasLog = strtok_r(NULL, "\t", &save);
+
+			if (name == NULL || path == NULL || hasLog == NULL)
+			{
+				return;
+			}
+
+			StatusSnapshot::iterator it = ClientFind(snap, name);
+
+			if (it == snap.end() || it->name != name)
+			{
+				it = snap.insert(it, ServiceStatus());
+				it->name = name;
+				cs.reset = true;
+			}
+
+			it->path = path;
+			it->hasLog = (atoi(hasLog) != 0);
+			ClientParseSupervise(&save, it->srv);
+			ClientParseSupervise(&save, it->log);
+
+			cs.changed.push_back(it - snap.begin());
+			break;
+		}
+		case 'R':
+		{
+			char const* const name = strtok_r(NULL, "\t", &save);
+
+			StatusSnapshot::iterator it = (name != NULL) ? ClientFind(snap, name) : snap.end();
+
+			if (it != snap.end() && it->name == name)
+			{
+				snap.erase(it);
+				cs.reset = true;
+			}
+			break;
+		}
+		case 'E':
+			++cs.batches;
+			break;
+		case 'A':
+		{
+			char const* const id = strtok_r(NULL, "\t", &save);
+			char const* const error = strtok_r(NULL, "\t", &save);
+
+			if (id != NULL && error != NULL)
+			{
+				cs.replies.push_back({ atoi(id), atoi(error) });
+			}
+			break;
+		}
+		default:
+			break;
+	}
+}
+
+
+bool ClientRead(int const fd, ClientState& cs, StatusSnapshot& snap)
+{
+	char buffer[16384];
+
+	for (;;)
+	{
+		ssize_t const n = read(fd, buffer, sizeof(buffer));
+
+		if (n == 0)
+		{
+			return false;
+		}
+
+		if (n == -1)
+		{
+			return errno == EAGAIN || errno == EINTR;
+		}
+
+		cs.in.append(buffer, n);
+
+		size_t start = 0;
+		size_t end;
+
+		while ((end = cs.in.find('\n', start)) != std::string::npos)
+		{
+			cs.in[end] = '\0';
+			ClientParse(cs, snap, &cs.in[start]);
+			start = end + 1;
+		}
+
+		cs.in.erase(0, start);
+	}
+}
+
+
+bool ClientWait(int const fd, ClientState& cs, StatusSnapshot& snap, size_t const replies)
+{
+	while (cs.batches == 0 || cs.replies.size() < replies)
+	{
+		struct pollfd pfd = { fd, POLLIN, 0 };
+
+		int const n = poll(&pfd, 1, CLIENT_WAIT_MAX);
+
+		if (n == 0)
+		{
+			errno = ETIMEDOUT;
+			return false;
+		}
+
+		if (n == -1 && errno != EINTR)
+		{
+			return false;
+		}
+
+		if (!ClientRead(fd, cs, snap))
+		{
+			errno = ECONNRESET;
+			return false;
+		}
+	}
+
+	return true;
+}
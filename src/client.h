@@ -0,0 +1,54 @@
+/*
+	Copyright 2026 Daniel T. Borelli <danieltborelli@gmail.com>
+
+	This file is part of xrunit.
+
+	xrunit is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	xrunit is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with xrunit.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef CLIENT_H_INCLUDE
+#define CLIENT_H_INCLUDE
+
+/*
+ * Client side of the xrunitd socket, see daemon.h. The snapshot is
+ * kept by name like StatusScan and updated with the deltas.
+ * Does not use fltk.
+ */
+
+struct ClientReply
+{
+	int id;
+	int error;
+};
+
+struct ClientState
+{
+	std::string in;                    /* incomplete line */
+	std::vector<size_t> changed;       /* updated services, in the snapshot */
+	std::vector<ClientReply> replies;
+	bool reset;                        /* services added or removed */
+	int batches;                       /* 'E' received */
+};
+
+int ClientConnect(char const* const path);
+
+bool ClientSend(int const fd, int const id, char const* const action, char const* const service);
+
+/* What is available without blocking, false when the daemon is gone. */
+bool ClientRead(int const fd, ClientState& cs, StatusSnapshot& snap);
+
+/* Blocks until a batch or the replies of 'replies' commands arrive. */
+bool ClientWait(int const fd, ClientState& cs, StatusSnapshot& snap, size_t const replies);
+
+#endif
@@ -0,0 +1,107 @@
+/*
+	Copyright 2026 Daniel T. Borelli <danieltborelli@gmail.com>
+
+	This file is part of xrunit.
+
+	xrunit is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	xrunit is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with xrunit.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "config.h"
+#include "control.h"
+
+struct ControlAction
+{
+	char const* action;
+	char const* cmd;
+};
+
+/* Same bytes that sv(8) writes for each of its commands. */
+static struct ControlAction const CONTROL_ACTION[] = {
+	{ "up",        "u" },
+	{ "down",      "d" },
+	{ "restart",   "tcu" },
+	{ "once",      "o" },
+	{ "pause",     "p" },
+	{ "cont",      "c" },
+	{ "hup",       "h" },
+	{ "alarm",     "a" },
+	{ "interrupt", "i" },
+	{ "quit",      "q" },
+	{ "1",         "1" },
+	{ "2",         "2" },
+	{ "term",      "t" },
+	{ "kill",      "k" },
+	{ "exit",      "x" },
+};
+
+
+char const* ControlCommand(char const* const action)
+{
+	ASSERT_DBG_STRING(action);
+
+	for (struct ControlAction const& it : CONTROL_ACTION)
+	{
+		if (strcmp(it.action, action) == 0)
+		{
+			return it.cmd;
+		}
+	}
+
+	return NULL;
+}
+
+
+/*
+ * 'dir' is the service directory.
+ * Returns 0 or the errno value, ENXIO when runsv is not running.
+ */
+int ControlSend(char const* const dir, char const* const cmd)
+{
+	ASSERT_DBG_STRING(dir);
+	ASSERT_DBG_STRING(cmd);
+
+	std::string path = dir;
+	path += "/supervise/control";
+
+	errno = 0;
+
+	int const fd = open(path.c_str(), O_WRONLY | O_NONBLOCK | O_CLOEXEC);
+
+	if (fd == -1)
+	{
+		return errno;
+	}
+
+	size_t const len = strlen(cmd);
+
+	errno = 0;
+
+	ssize_t const n = write(fd, cmd, len);
+
+	int const error = (n == (ssize_t)len) ? 0 : ((n == -1) ? errno : EAGAIN);
+
+	close(fd);
+
+	return error;
+}
+
+
+char const* ControlError(int const error)
+{
+	if (error == ENXIO || error == ENODEV)
+	{
+		return "runsv not running";
+	}
+
+	return strerror(error);
+}
@@ -0,0 +1,35 @@
+/*
+	Copyright 2026 Daniel T. Borelli <danieltborelli@gmail.com>
+
+	This file is part of xrunit.
+
+	xrunit is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	xrunit is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with xrunit.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef CONTROL_H_INCLUDE
+#define CONTROL_H_INCLUDE
+
+/*
+ * Sends runit commands writing directly into the
+ * 'supervise/control' fifo of a service, see runsv(8).
+ * Does not use fltk, it is also used outside the GUI.
+ */
+
+char const* ControlCommand(char const* const action);
+
+int ControlSend(char const* const dir, char const* const cmd);
+
+char const* ControlError(int const error);
+
+#endif
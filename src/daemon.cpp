@@ -0,0 +1,560 @@
+/*
+	Copyright 2026 Daniel T. Borelli <danieltborelli@gmail.com>
+
+	This file is part of xrunit.
+
+	xrunit is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	xrunit is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with xrunit.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "config.h"
+#include "status.h"
+#include "control.h"
+#include "watch.h"
+#include "daemon.h"
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <poll.h>
+#include <signal.h>
+#include <grp.h>
+
+/* A client that does not read is dropped, not waited. */
+#define DAEMON_OUT_MAX (4 * 1024 * 1024)
+
+#define DAEMON_CLIENTS_MAX 64
+
+struct DaemonClient
+{
+	int fd;
+	uid_t uid;
+	std::string in;
+	std::string out;
+};
+
+static char const* daemonRunDir = SV_RUN_DIR;
+
+static int listenFd = -1;
+
+static int watchFd = -1;
+
+static StatusSnapshot snapshot;
+
+/* Last line sent of each service, the deltas are the lines that differ. */
+static std::unordered_map<std::string, std::string> sent;
+
+static std::vector<DaemonClient> clients;
+
+static volatile sig_atomic_t daemonQuit = 0;
+
+
+bool DaemonIsCommand(int const argc, char* argv[])
+{
+	if (argc < 1)
+	{
+		return false;
+	}
+
+	char const* const name = strrchr(argv[0], '/');
+
+	if (strcmp((name != NULL) ? name + 1 : argv[0], "xrunitd") == 0)
+	{
+		return true;
+	}
+
+	return argc >= 2 && strcmp(argv[1], "--daemon") == 0;
+}
+
+
+static void DaemonQuitHandler(UNUSED int sig)
+{
+	daemonQuit = 1;
+}
+
+
+static int DaemonFlags(SuperviseStatus const& st)
+{
+	return (st.paused ? DAEMON_FLAG_PAUSED : 0)
+		| (st.wantUp ? DAEMON_FLAG_WANT_UP : 0)
+		| (st.wantDown ? DAEMON_FLAG_WANT_DOWN : 0)
+		| (st.gotTerm ? DAEMON_FLAG_GOT_TERM : 0)
+		| (st.normallyUp ? DAEMON_FLAG_NORMALLY_UP : 0);
+}
+
+
+static void DaemonFormat(ServiceStatus const& st, std::string& line)
+{
+	char str[256];
+
+	snprintf(str, sizeof(str), "\t%d\t%ld\t%d\t%d\t%d\t%d\t%ld\t%d\t%d\t%d\t%d\n", st.hasLog ? 1 : 0,
+		(long)st.srv.since, (int)st.srv.pid, st.srv.state, st.srv.error, DaemonFlags(st.srv),
+		(long)st.log.since, (int)st.log.pid, st.log.state, st.log.error, DaemonFlags(st.log));
+
+	line = "S\t";
+	line += st.name;
+	line += "\t";
+	line += st.path;
+	line += str;
+}
+
+
+/* The names are directory entries, the protocol can not carry every byte. */
+static bool DaemonValidName(std::string const& name)
+{
+	return !name.empty() && name.size() < DAEMON_LINE_MAX / 2 &&
+		name.find_first_of("\t\n/") == std::string::npos;
+}
+
+
+static void DaemonCloseClient(size_t const i)
+{
+	close(clients[i].fd);
+	clients.erase(clients.begin() + i);
+}
+
+
+static void DaemonQueue(DaemonClient& client, std::string const& msg)
+{
+	client.out += msg;
+}
+
+
+static void DaemonSnapshot(DaemonClient& client)
+{
+	for (auto const& it : sent)
+	{
+		DaemonQueue(client, it.second);
+	}
+
+	DaemonQueue(client, "E\n");
+}
+
+
+/* Only the services whose record changed since the last batch. */
+static void DaemonPublish(void)
+{
+	std::string delta;
+	std::string line;
+
+	std::unordered_set<std::string> names;
+
+	for (ServiceStatus const& st : snapshot)
+	{
+		if (!DaemonValidName(st.name) || st.path.find_first_of("\t\n") != std::string::npos)
+		{
+			continue;
+		}
+
+		names.insert(st.name);
+
+		DaemonFormat(st, line);
+
+		std::string& last = sent[st.name];
+
+		if (last != line)
+		{
+			last = line;
+			delta += line;
+		}
+	}
+
+	for (auto it = sent.begin(); it != sent.end(); )
+	{
+		if (names.count(it->first) == 0)
+		{
+			delta += "R\t";
+			delta += it->first;
+			delta += "\n";
+			it = sent.erase(it);
+		}
+		else
+		{
+			++it;
+		}
+	}
+
+	if (delta.empty())
+	{
+		return;
+	}
+
+	delta += "E\n";
+
+	for (DaemonClient& client : clients)
+	{
+		DaemonQueue(client, delta);
+	}
+}
+
+
+static void DaemonScan(void)
+{
+	if (!StatusScan(daemonRunDir, snapshot))
+	{
+		fprintf(stderr, "xrunitd: %s: %s\n", daemonRunDir, strerror(errno));
+		return;
+	}
+
+	if (watchFd != -1)
+	{
+		WatchReset();
+
+		for (size_t i = 0; i < snapshot.size(); ++i)
+		{
+			WatchAdd(snapshot[i].path.c_str(), i);
+		}
+	}
+
+	DaemonPublish();
+}
+
+
+static void DaemonCommand(DaemonClient& client, char* line)
+{
+	char* save = NULL;
+
+	char const* const id = strtok_r(line + 1, "\t", &save);
+	char const* const action = strtok_r(NULL, "\t", &save);
+	char const* const service = strtok_r(NULL, "\t", &save);
+
+	if (id == NULL || action == NULL || service == NULL)
+	{
+		return;
+	}
+
+	char const* const cmd = ControlCommand(action);
+
+	std::string name = service;
+
+	size_t const log = name.rfind("/log");
+
+	bool const isLog = (log != std::string::npos && log + 4 == name.size());
+
+	if (isLog)
+	{
+		name.erase(log);
+	}
+
+	int error = 0;
+
+	// Only a known service: the client is not trusted with paths.
+	if (cmd == NULL || !DaemonValidName(name) || sent.count(name) == 0)
+	{
+		error = EINVAL;
+	}
+	else
+	{
+		std::string dir = daemonRunDir;
+		dir += "/";
+		dir += name;
+		dir += isLog ? "/log" : "";
+
+		error = ControlSend(dir.c_str(), cmd);
+
+		fprintf(stderr, "xrunitd: uid %d: %s %s: %s\n", (int)client.uid, action, service,
+			error ? ControlError(error) : "ok");
+	}
+
+	char str[64];
+
+	snprintf(str, sizeof(str), "A\t%d\t%d\n", atoi(id), error);
+
+	DaemonQueue(client, str);
+}
+
+
+static bool DaemonWriteClient(DaemonClient& client);
+
+
+static void DaemonAccept(void)
+{
+	int const fd = accept4(listenFd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+
+	if (fd == -1)
+	{
+		return;
+	}
+
+	if (clients.size() >= DAEMON_CLIENTS_MAX)
+	{
+		close(fd);
+		return;
+	}
+
+	struct ucred cred;
+	socklen_t len = sizeof(cred);
+
+	if (getsockopt(fd, SOL_SOCKET, SO_PEERCRED, &cred, &len) == -1)
+	{
+		cred.uid = (uid_t)-1;
+	}
+
+	clients.push_back(DaemonClient());
+
+	DaemonClient& client = clients.back();
+
+	client.fd = fd;
+	client.uid = cred.uid;
+
+	DaemonSnapshot(client);
+	DaemonWriteClient(client);
+}
+
+
+/* False when the client is gone or misbehaves. */
+static bool DaemonReadClient(DaemonClient& client)
+{
+	char buffer[DAEMON_LINE_MAX];
+
+	for (;;)
+	{
+		ssize_t const n = read(client.fd, buffer, sizeof(buffer));
+
+		if (n == 0)
+		{
+			return false;
+		}
+
+		if (n == -1)
+		{
+			return errno == EAGAIN || errno == EINTR;
+		}
+
+		client.in.append(buffer, n);
+
+		size_t start = 0;
+		size_t end;
+
+		while ((end = client.in.find('\n', start)) != std::string::npos)
+		{
+			client.in[end] = '\0';
+
+			if (client.in[start] == 'C')
+			{
+				DaemonCommand(client, &client.in[start]);
+			}
+
+			start = end + 1;
+		}
+
+		client.in.erase(0, start);
+
+		if (client.in.size() > DAEMON_LINE_MAX)
+		{
+			return false;
+		}
+	}
+}
+
+
+static bool DaemonWriteClient(DaemonClient& client)
+{
+	while (!client.out.empty())
+	{
+		ssize_t const n = send(client.fd, client.out.data(), client.out.size(), MSG_NOSIGNAL);
+
+		if (n == -1)
+		{
+			return errno == EAGAIN || errno == EINTR;
+		}
+
+		client.out.erase(0, n);
+	}
+
+	return true;
+}
+
+
+static int DaemonListen(char const* const socketPath)
+{
+	struct sockaddr_un addr;
+
+	memset(&addr, 0, sizeof(addr));
+
+	addr.sun_family = AF_UNIX;
+
+	if (strlen(socketPath) >= sizeof(addr.sun_path))
+	{
+		errno = ENAMETOOLONG;
+		return -1;
+	}
+
+	strcpy(addr.sun_path, socketPath);
+
+	int const fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+
+	if (fd == -1)
+	{
+		return -1;
+	}
+
+	// A socket left by a previous xrunitd.
+	unlink(socketPath);
+
+	mode_t const mask = umask(0177);
+
+	int const bound = bind(fd, (struct sockaddr*)&addr, sizeof(addr));
+
+	umask(mask);
+
+	if (bound == -1 || chmod(socketPath, XRUNITD_SOCKET_MODE) == -1 || listen(fd, 16) == -1)
+	{
+		int const error = errno;
+		close(fd);
+		errno = error;
+		return -1;
+	}
+
+#ifdef XRUNITD_GROUP
+	struct group const* gr = getgrnam(XRUNITD_GROUP);
+
+	if (gr == NULL || chown(socketPath, 0, gr->gr_gid) == -1)
+	{
+		fprintf(stderr, "xrunitd: group '%s' of %s: %s\n", XRUNITD_GROUP, socketPath,
+			(gr == NULL) ? "not found" : strerror(errno));
+	}
+#endif
+
+	return fd;
+}
+
+
+int DaemonRun(char const* const runDir, char const* const socketPath)
+{
+	ASSERT_DBG_STRING(runDir);
+	ASSERT_DBG_STRING(socketPath);
+
+	if (geteuid() != 0)
+	{
+		fprintf(stderr, "xrunitd: administrator permissions are required\n");
+		return EXIT_FAILURE;
+	}
+
+	daemonRunDir = runDir;
+
+	listenFd = DaemonListen(socketPath);
+
+	if (listenFd == -1)
+	{
+		fprintf(stderr, "xrunitd: %s: %s\n", socketPath, strerror(errno));
+		return EXIT_FAILURE;
+	}
+
+	struct sigaction sa;
+
+	memset(&sa, 0, sizeof(sa));
+	sa.sa_handler = DaemonQuitHandler;
+	sigaction(SIGTERM, &sa, NULL);
+	sigaction(SIGINT, &sa, NULL);
+
+	watchFd = WatchOpen(runDir);
+
+	if (watchFd == -1)
+	{
+		fprintf(stderr, "xrunitd: inotify is not available, polling every %d seconds\n", TIME_UPDATE);
+	}
+
+	DaemonScan();
+
+	time_t nextScan = 0;
+
+	std::vector<struct pollfd> fds;
+
+	while (!daemonQuit)
+	{
+		time_t const now = time(NULL);
+
+		if (now >= nextScan)
+		{
+			if (nextScan != 0)
+			{
+				DaemonScan();
+			}
+
+			nextScan = now + ((watchFd != -1) ? TIME_SAFETY : TIME_UPDATE);
+		}
+
+		fds.clear();
+		fds.push_back({ listenFd, POLLIN, 0 });
+		fds.push_back({ watchFd, POLLIN, 0 });
+
+		for (DaemonClient const& client : clients)
+		{
+			fds.push_back({ client.fd, (short)(POLLIN | (client.out.empty() ? 0 : POLLOUT)), 0 });
+		}
+
+		int const n = poll(fds.data(), fds.size(), (int)(nextScan - now) * 1000);
+
+		if (n <= 0)
+		{
+			continue;
+		}
+
+		if (fds[1].revents & POLLIN)
+		{
+			std::vector<size_t> changed;
+
+			// Also when runsv created the supervise directory of a new service.
+			if (WatchRead(changed))
+			{
+				DaemonScan();
+			}
+			else if (!changed.empty())
+			{
+				for (size_t const id : changed)
+				{
+					ASSERT_DBG(id < snapshot.size());
+					StatusReadService(&snapshot[id]);
+				}
+
+				DaemonPublish();
+			}
+		}
+
+		// From the last, the indexes of fds do not move.
+		for (size_t i = clients.size(); i-- > 0; )
+		{
+			short const revents = fds[i + 2].revents;
+
+			bool alive = true;
+
+			if (revents & (POLLIN | POLLHUP | POLLERR))
+			{
+				alive = DaemonReadClient(clients[i]);
+			}
+
+			alive = alive && DaemonWriteClient(clients[i]) && clients[i].out.size() <= DAEMON_OUT_MAX;
+
+			if (!alive)
+			{
+				DaemonCloseClient(i);
+			}
+		}
+
+		if (fds[0].revents & POLLIN)
+		{
+			DaemonAccept();
+		}
+	}
+
+	for (size_t i = clients.size(); i-- > 0; )
+	{
+		DaemonCloseClient(i);
+	}
+
+	close(listenFd);
+	unlink(socketPath);
+	WatchClose();
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,56 @@
+/*
+	Copyright 2026 Daniel T. Borelli <danieltborelli@gmail.com>
+
+	This file is part of xrunit.
+
+	xrunit is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	xrunit is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with xrunit.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef DAEMON_H_INCLUDE
+#define DAEMON_H_INCLUDE
+
+/*
+ * xrunitd: one privileged process reads the status of the services
+ * and sends the runit commands for any number of clients connected
+ * to a Unix socket, the permissions of the socket decide who may use it.
+ * Does not use fltk.
+ *
+ * Text protocol, one message per line, fields separated by tabs:
+ *
+ *   daemon -> client
+ *     S name path hasLog srv.since srv.pid srv.state srv.error srv.flags log...
+ *     R name                   the service is gone
+ *     E                        end of a batch, the first one is the snapshot
+ *     A id error               answer of a command, errno or 0
+ *
+ *   client -> daemon
+ *     C id action service      service is 'name' or 'name/log'
+ */
+
+#define DAEMON_LINE_MAX 4096
+
+enum {
+	DAEMON_FLAG_PAUSED = 1,
+	DAEMON_FLAG_WANT_UP = 2,
+	DAEMON_FLAG_WANT_DOWN = 4,
+	DAEMON_FLAG_GOT_TERM = 8,
+	DAEMON_FLAG_NORMALLY_UP = 16,
+};
+
+/* argv[1] is --daemon, or the program was called as xrunitd. */
+bool DaemonIsCommand(int const argc, char* argv[]);
+
+int DaemonRun(char const* const runDir, char const* const socketPath);
+
+#endif
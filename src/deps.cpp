@@ -0,0 +1,493 @@
+/*
+	Copyright 2026 Daniel T. Borelli <danieltborelli@gmail.com>
+
+	This file is part of xrunit.
+
+	xrunit is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	xrunit is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with xrunit.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "config.h"
+#include "status.h"
+#include "control.h"
+#include "launch.h"
+#include "perf.h"
+#include "deps.h"
+
+#include <signal.h>
+
+/* What must be ready before each service: its deps, or its dependents when stopping. */
+typedef std::unordered_map<std::string, std::vector<std::string> > DepsGraph;
+
+
+static bool DepsIsDir(std::string const& path)
+{
+	struct stat st;
+
+	return stat(path.c_str(), &st) == 0 && S_ISDIR(st.st_mode);
+}
+
+
+static bool DepsRead(char const* const svDir, std::string const& service,
+		std::vector<std::string>& deps, std::string& error)
+{
+	deps.clear();
+
+	std::string const path = std::string(svDir) + "/" + service + "/deps";
+
+	errno = 0;
+
+	FILE* file = fopen(path.c_str(), "re");
+
+	if (file == NULL)
+	{
+		if (errno == ENOENT)
+		{
+			return true;
+		}
+
+		error = path + ": " + strerror(errno);
+		return false;
+	}
+
+	char* line = NULL;
+	size_t size = 0;
+	bool ok = true;
+
+	while (ok && getline(&line, &size, file) != -1)
+	{
+		char* const comment = strchr(line, '#');
+
+		if (comment != NULL)
+		{
+			*comment = '\0';
+		}
+
+		char* save = NULL;
+
+		for (char* name = strtok_r(line, " \t\r\n", &save); name != NULL;
+				name = strtok_r(NULL, " \t\r\n", &save))
+		{
+			if (strchr(name, '/') != NULL || strcmp(name, ".") == 0 || strcmp(name, "..") == 0)
+			{
+				error = path + ": invalid service name '" + name + "'";
+				ok = false;
+				break;
+			}
+
+			if (std::find(deps.begin(), deps.end(), name) == deps.end())
+			{
+				deps.push_back(name);
+			}
+		}
+	}
+
+	free(line);
+	fclose(file);
+
+	return ok;
+}
+
+
+/* Starting: the services and all they need, each one enabled in 'runDir'. */
+static bool DepsGraphUp(char const* const svDir, char const* const runDir,
+		std::vector<std::string> const& services, DepsGraph& before, std::string& error)
+{
+	std::deque<std::string> queue(services.begin(), services.end());
+	std::unordered_map<std::string, std::string> neededBy;
+
+	while (!queue.empty())
+	{
+		std::string const name = queue.front();
+		queue.pop_front();
+
+		if (before.count(name) != 0)
+		{
+			continue;
+		}
+
+		if (!DepsIsDir(std::string(runDir) + "/" + name))
+		{
+			error = "'" + name + "' is not enabled in " + runDir;
+
+			if (neededBy.count(name) != 0)
+			{
+				error += ", '" + neededBy[name] + "' needs it";
+			}
+
+			return false;
+		}
+
+		std::vector<std::string>& deps = before[name];
+
+		if (!DepsRead(svDir, name, deps, error))
+		{
+			return false;
+		}
+
+		for (std::string const& dep : deps)
+		{
+			neededBy.emplace(dep, name);
+			queue.push_back(dep);
+		}
+	}
+
+	return true;
+}
+
+
+/* Stopping: the services and the enabled ones that need them, directly or not. */
+static bool DepsGraphDown(char const* const svDir, char const* const runDir,
+		std::vector<std::string> const& services, DepsGraph& before, std::string& error)
+{
+	DepsGraph dependents;
+
+	DIR* dir = opendir(runDir);
+
+	if (dir == NULL)
+	{
+		error = std::string(runDir) + ": " + strerror(errno);
+		return false;
+	}
+
+	std::vector<std::string> deps;
+	bool ok = true;
+
+	for (struct dirent* ent = readdir(dir); ok && ent != NULL; ent = readdir(dir))
+	{
+		if (ent->d_name[0] == '.')
+		{
+			continue;
+		}
+
+		ok = DepsRead(svDir, ent->d_name, deps, error);
+
+		for (std::string const& dep : deps)
+		{
+			dependents[dep].push_back(ent->d_name);
+		}
+	}
+
+	closedir(dir);
+
+	if (!ok)
+	{
+		return false;
+	}
+
+	std::deque<std::string> queue(services.begin(), services.end());
+
+	for (std::string const& name : services)
+	{
+		if (!DepsIsDir(std::string(runDir) + "/" + name))
+		{
+			error = "'" + name + "' is not enabled in " + runDir;
+			return false;
+		}
+	}
+
+	while (!queue.empty())
+	{
+		std::string const name = queue.front();
+		queue.pop_front();
+
+		if (before.count(name) != 0)
+		{
+			continue;
+		}
+
+		std::vector<std::string>& list = before[name];
+
+		list = dependents[name];
+		queue.insert(queue.end(), list.begin(), list.end());
+	}
+
+	return true;
+}
+
+
+/* Longest chain of 'before' under 'name', -1 while it is being visited. */
+static bool DepsLevel(std::string const& name, DepsGraph const& before,
+		std::unordered_map<std::string, int>& level, std::vector<std::string>& path,
+		std::string& error)
+{
+	auto const found = level.find(name);
+
+	if (found != level.end())
+	{
+		if (found->second != -1)
+		{
+			return true;
+		}
+
+		error = "dependency cycle:";
+
+		for (auto it = std::find(path.begin(), path.end(), name); it != path.end(); ++it)
+		{
+			error += " " + *it + " ->";
+		}
+
+		error += " " + name;
+		return false;
+	}
+
+	level[name] = -1;
+	path.push_back(name);
+
+	int max = 0;
+
+	for (std::string const& other : before.at(name))
+	{
+		if (!DepsLevel(other, before, level, path, error))
+		{
+			return false;
+		}
+
+		max = std::max(max, level[other] + 1);
+	}
+
+	path.pop_back();
+	level[name] = max;
+
+	return true;
+}
+
+
+bool DepsWaves(char const* const svDir, char const* const runDir,
+		std::vector<std::string> const& services, bool const up,
+		std::vector<std::vector<std::string> >& waves, std::string& error)
+{
+	ASSERT_DBG_STRING(svDir);
+	ASSERT_DBG_STRING(runDir);
+
+	waves.clear();
+
+	for (std::string const& name : services)
+	{
+		if (name.empty() || name.find('/') != std::string::npos || name == "." || name == "..")
+		{
+			error = "'" + name + "' is not a service of " + runDir;
+			return false;
+		}
+	}
+
+	DepsGraph before;
+
+	if (!(up ? DepsGraphUp(svDir, runDir, services, before, error)
+			: DepsGraphDown(svDir, runDir, services, before, error)))
+	{
+		return false;
+	}
+
+	std::unordered_map<std::string, int> level;
+	std::vector<std::string> path;
+
+	for (auto const& it : before)
+	{
+		if (!DepsLevel(it.first, before, level, path, error))
+		{
+			return false;
+		}
+
+		size_t const wave = level[it.first];
+
+		if (waves.size() <= wave)
+		{
+			waves.resize(wave + 1);
+		}
+	}
+
+	for (auto const& it : level)
+	{
+		waves[it.second].push_back(it.first);
+	}
+
+	for (std::vector<std::string>& wave : waves)
+	{
+		std::sort(wave.begin(), wave.end());
+	}
+
+	return true;
+}
+
+
+static void DepsSendWave(DepsRun& run)
+{
+	std::vector<std::string> const& wave = run.waves[run.wave];
+
+	char const* const cmd = ControlCommand(run.up ? "up" : "down");
+
+	run.message = "wave " + std::to_string(run.wave + 1) + "/" + std::to_string(run.waves.size()) + ":";
+	run.waiting.clear();
+
+	for (std::string const& name : wave)
+	{
+		run.message += " " + name;
+
+		int const error = ControlSend((run.runDir + "/" + name).c_str(), cmd);
+
+		if (error != 0)
+		{
+			run.failed.push_back(name + " (" + ControlError(error) + ")");
+		}
+
+		DepsWait wait;
+		wait.name = name;
+		wait.check = -1;
+		wait.ready = false;
+
+		run.waiting.push_back(wait);
+	}
+
+	run.deadline = PerfSeconds() + run.timeout;
+}
+
+
+bool DepsStart(DepsRun& run, char const* const svDir, char const* const runDir,
+		std::vector<std::string> const& services, bool const up,
+		int const timeout, std::string& error)
+{
+	ASSERT_DBG(timeout > 0);
+
+	run.runDir = runDir;
+	run.failed.clear();
+	run.waiting.clear();
+	run.message.clear();
+	run.timeout = timeout;
+	run.wave = 0;
+	run.up = up;
+
+	if (!DepsWaves(svDir, runDir, services, up, run.waves, error))
+	{
+		return false;
+	}
+
+	DepsSendWave(run);
+
+	return true;
+}
+
+
+/* Like sv(8): 'run', then './check' in the service directory if there is one. */
+static bool DepsReady(DepsRun const& run, DepsWait& wait)
+{
+	std::string const dir = run.runDir + "/" + wait.name;
+
+	if (wait.check != -1)
+	{
+		int status = 0;
+
+		pid_t const ret = waitpid(wait.check, &status, WNOHANG);
+
+		if (ret == 0)
+		{
+			return false;
+		}
+
+		wait.check = -1;
+
+		// Not ready yet, it runs again in the next step.
+		return ret > 0 && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+	}
+
+	SuperviseStatus st;
+
+	StatusReadSupervise(AT_FDCWD, dir.c_str(), &st);
+
+	if (!run.up)
+	{
+		return st.state == STATE_DOWN;
+	}
+
+	if (st.state != STATE_RUN)
+	{
+		return false;
+	}
+
+	std::string const check = dir + "/check";
+
+	if (access(check.c_str(), X_OK) != 0)
+	{
+		return true;
+	}
+
+	char* argv[] = { (char*)"./check", NULL };
+
+	wait.check = LaunchSpawn(check.c_str(), argv, -1, dir.c_str());
+
+	return false;
+}
+
+
+int DepsStep(DepsRun& run)
+{
+	run.message.clear();
+
+	if (!run.failed.empty())
+	{
+		DepsAbort(run);
+		return DEPS_FAILED;
+	}
+
+	bool all = true;
+
+	for (DepsWait& wait : run.waiting)
+	{
+		wait.ready = wait.ready || DepsReady(run, wait);
+		all = all && wait.ready;
+	}
+
+	if (all)
+	{
+		if (++run.wave == run.waves.size())
+		{
+			run.waiting.clear();
+			return DEPS_DONE;
+		}
+
+		DepsSendWave(run);
+		return DEPS_RUNNING;
+	}
+
+	if (PerfSeconds() < run.deadline)
+	{
+		return DEPS_RUNNING;
+	}
+
+	for (DepsWait const& wait : run.waiting)
+	{
+		if (!wait.ready)
+		{
+			run.failed.push_back(wait.name + " (not ready)");
+		}
+	}
+
+	DepsAbort(run);
+
+	return DEPS_FAILED;
+}
+
+
+void DepsAbort(DepsRun& run)
+{
+	for (DepsWait& wait : run.waiting)
+	{
+		if (wait.check != -1)
+		{
+			kill(wait.check, SIGKILL);
+			waitpid(wait.check, NULL, 0);
+			wait.check = -1;
+		}
+	}
+
+	run.waiting.clear();
+}
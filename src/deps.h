@@ -0,0 +1,78 @@
+/*
+	Copyright 2026 Daniel T. Borelli <danieltborelli@gmail.com>
+
+	This file is part of xrunit.
+
+	xrunit is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	xrunit is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with xrunit.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef DEPS_H_INCLUDE
+#define DEPS_H_INCLUDE
+
+/*
+ * Starts or stops a set of services in waves, by the 'deps' file of each
+ * one in SV_DIR: the names of the services it needs, separated by blanks,
+ * '#' until the end of the line is a comment.
+ *
+ * Starting pulls in what the services need, stopping pulls in the enabled
+ * services that need them. All the services of a wave get their command
+ * at once, the next wave waits until each one is ready: 'run' and its
+ * 'check' exits 0, like sv(8) start, or 'down' when stopping.
+ * Does not use fltk, it is also used outside the GUI.
+ */
+
+/* Seconds between two DepsStep. */
+#define DEPS_POLL 0.2
+
+enum {
+	DEPS_RUNNING = 0,
+	DEPS_DONE,
+	DEPS_FAILED,
+};
+
+struct DepsWait
+{
+	std::string name;
+	pid_t check;                 /* running './check', or -1 */
+	bool ready;
+};
+
+struct DepsRun
+{
+	std::string runDir;
+	std::vector<std::vector<std::string> > waves;
+	std::vector<DepsWait> waiting;   /* the current wave */
+	std::vector<std::string> failed;
+	std::string message;             /* new wave or end, for the user */
+	double timeout;
+	double deadline;
+	size_t wave;
+	bool up;
+};
+
+bool DepsWaves(char const* const svDir, char const* const runDir,
+		std::vector<std::string> const& services, bool const up,
+		std::vector<std::vector<std::string> >& waves, std::string& error);
+
+/* 'error' when a name is unknown or the dependencies have a cycle. */
+bool DepsStart(DepsRun& run, char const* const svDir, char const* const runDir,
+		std::vector<std::string> const& services, bool const up,
+		int const timeout, std::string& error);
+
+/* Without blocking, DEPS_RUNNING until the last wave is ready or a timeout. */
+int DepsStep(DepsRun& run);
+
+void DepsAbort(DepsRun& run);
+
+#endif
@@ -0,0 +1,140 @@
+/*
+	Copyright 2026 Daniel T. Borelli <danieltborelli@gmail.com>
+
+	This file is part of xrunit.
+
+	xrunit is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	xrunit is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with xrunit.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "config.h"
+#include "system.h"
+#include "exec.h"
+#include "launch.h"
+
+#include <sys/syscall.h>
+
+/* Without pidfd (linux < 5.3) the child is polled. */
+#define EXEC_POLL_TIME 0.1
+
+struct ExecJob
+{
+	pid_t pid;
+	int pidfd;
+	ExecDoneCb doneCb;
+	void* data;
+};
+
+static int execPending = 0;
+
+static void ExecPollCb(void* data);
+
+
+static bool ExecReap(struct ExecJob* job)
+{
+	int status = 0;
+
+	pid_t const ret = waitpid(job->pid, &status, WNOHANG);
+
+	if (ret == 0 || (ret == -1 && errno == EINTR))
+	{
+		return false;
+	}
+
+	if (ret == -1)
+	{
+		WARNING("waitpid(%d) failed: %s", (int)job->pid, strerror(errno));
+		status = W_EXITCODE(127, 0);
+	}
+
+	if (job->pidfd != -1)
+	{
+		Fl::remove_fd(job->pidfd);
+		close(job->pidfd);
+	}
+
+	--execPending;
+
+	ExecDoneCb const doneCb = job->doneCb;
+	void* const data = job->data;
+
+	delete job;
+
+	if (doneCb)
+	{
+		doneCb(status, data);
+	}
+
+	return true;
+}
+
+
+static void ExecPidfdCb(UNUSED int fd, void* data)
+{
+	ExecReap((struct ExecJob*)data);
+}
+
+
+static void ExecPollCb(void* data)
+{
+	if (!ExecReap((struct ExecJob*)data))
+	{
+		Fl::repeat_timeout(EXEC_POLL_TIME, ExecPollCb, data);
+	}
+}
+
+
+bool ExecAsync(char const* const exec, char* const* argv, ExecDoneCb doneCb, void* data)
+{
+	ASSERT_DBG_STRING(exec);
+	ASSERT_DBG(argv);
+
+	errno = 0;
+
+	pid_t const pid = LaunchSpawn(exec, argv, -1, NULL);
+
+	if (pid == -1)
+	{
+		fl_alert("There was a failure while creating the process %s\nError:%s", exec, strerror(errno));
+		return false;
+	}
+
+	struct ExecJob* job = new ExecJob;
+
+	job->pid = pid;
+	job->doneCb = doneCb;
+	job->data = data;
+#ifdef SYS_pidfd_open
+	job->pidfd = (int)syscall(SYS_pidfd_open, pid, 0);
+#else
+	job->pidfd = -1;
+#endif
+
+	++execPending;
+
+	if (job->pidfd != -1)
+	{
+		Fl::add_fd(job->pidfd, FL_READ, ExecPidfdCb, (void*)job);
+	}
+	else
+	{
+		Fl::add_timeout(EXEC_POLL_TIME, ExecPollCb, (void*)job);
+	}
+
+	return true;
+}
+
+
+int ExecPending(void)
+{
+	return execPending;
+}
@@ -0,0 +1,35 @@
+/*
+	Copyright 2026 Daniel T. Borelli <danieltborelli@gmail.com>
+
+	This file is part of xrunit.
+
+	xrunit is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	xrunit is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with xrunit.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef EXEC_H_INCLUDE
+#define EXEC_H_INCLUDE
+
+/*
+ * Runs a child process without blocking the fltk loop.
+ * The child is reaped through a pidfd registered with Fl::add_fd
+ * and 'doneCb' receives the wait(2) status.
+ */
+
+typedef void (*ExecDoneCb)(int const status, void* data);
+
+bool ExecAsync(char const* const exec, char* const* argv, ExecDoneCb doneCb, void* data);
+
+int ExecPending(void);
+
+#endif
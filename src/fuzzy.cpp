@@ -0,0 +1,301 @@
+/*
+	Copyright 2026 Daniel T. Borelli <danieltborelli@gmail.com>
+
+	This file is part of xrunit.
+
+	xrunit is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	xrunit is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with xrunit.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "config.h"
+#include "fuzzy.h"
+
+#include <stdint.h>
+#include <ctype.h>
+
+/* Names tested by each step of the mask prefilter. */
+#define FUZZY_LANES 4
+
+#define FUZZY_SEPARATORS "-_.@/ "
+
+/* Score of each matched character and its bonuses. */
+#define FUZZY_MATCH 1
+#define FUZZY_CONSECUTIVE 5
+#define FUZZY_WORD_START 3
+/* Penalty for the characters skipped before the first match, at most. */
+#define FUZZY_LEADING_MAX 5
+
+typedef uint64_t FuzzyLanes __attribute__((vector_size(FUZZY_LANES * sizeof(uint64_t))));
+
+struct FuzzyScored
+{
+	int score;
+	uint32_t length;
+	uint32_t id;
+};
+
+
+/* One bit per letter, digit and common separator, the rest share bits. */
+static uint64_t FuzzyCharBit(unsigned char const c)
+{
+	if (c >= 'a' && c <= 'z')
+	{
+		return 1ULL << (c - 'a');
+	}
+
+	if (c >= '0' && c <= '9')
+	{
+		return 1ULL << (26 + c - '0');
+	}
+
+	switch (c)
+	{
+		case '-':
+			return 1ULL << 36;
+		case '_':
+			return 1ULL << 37;
+		case '.':
+			return 1ULL << 38;
+	}
+
+	return 1ULL << (39 + c % 25);
+}
+
+
+static uint64_t FuzzyMask(char const* s)
+{
+	uint64_t mask = 0;
+
+	for (; *s != '\0'; ++s)
+	{
+		mask |= FuzzyCharBit((unsigned char)*s);
+	}
+
+	return mask;
+}
+
+
+void FuzzyClear(FuzzyFilter& filter)
+{
+	filter.text.clear();
+	filter.offsets.clear();
+	filter.masks.clear();
+	filter.query.clear();
+	filter.candidates.clear();
+	filter.cached = false;
+}
+
+
+void FuzzyAdd(FuzzyFilter& filter, char const* const name)
+{
+	ASSERT_DBG(name);
+
+	size_t const id = filter.offsets.size();
+	size_t const off = filter.text.size();
+
+	for (char const* s = name; *s != '\0'; ++s)
+	{
+		filter.text += (char)tolower((unsigned char)*s);
+	}
+
+	filter.text += '\0';
+	filter.offsets.push_back((uint32_t)off);
+
+	if (filter.masks.size() <= id)
+	{
+		filter.masks.resize(id + FUZZY_LANES, 0);
+	}
+
+	filter.masks[id] = FuzzyMask(filter.text.c_str() + off);
+	filter.cached = false;
+}
+
+
+/* 'q' in order inside 'name', the greedy match is scored. */
+static bool FuzzyScore(char const* const name, std::string const& q, int* score)
+{
+	int s = 0;
+	int last = -2;
+	size_t j = 0;
+
+	for (int i = 0; name[i] != '\0' && j < q.size(); ++i)
+	{
+		if (name[i] != q[j])
+		{
+			continue;
+		}
+
+		s += FUZZY_MATCH;
+
+		if (i == last + 1)
+		{
+			s += FUZZY_CONSECUTIVE;
+		}
+
+		if (i == 0 || strchr(FUZZY_SEPARATORS, name[i - 1]) != NULL)
+		{
+			s += FUZZY_WORD_START;
+		}
+
+		if (j == 0)
+		{
+			s -= std::min(i, FUZZY_LEADING_MAX);
+		}
+
+		last = i;
+		++j;
+	}
+
+	*score = s;
+
+	return j == q.size();
+}
+
+
+/* The names having every character of the query, a block at a time. */
+static void FuzzyPrefilter(FuzzyFilter const& filter, uint64_t const qmask, std::vector<uint32_t>& out)
+{
+	ASSERT_DBG(qmask != 0);
+
+	FuzzyLanes q;
+
+	for (int l = 0; l < FUZZY_LANES; ++l)
+	{
+		q[l] = qmask;
+	}
+
+	size_t const n = filter.offsets.size();
+
+	for (size_t i = 0; i < n; i += FUZZY_LANES)
+	{
+		FuzzyLanes v;
+
+		memcpy(&v, &filter.masks[i], sizeof(v));
+
+		auto const hit = ((v & q) == q);
+
+		bool any = false;
+
+		for (int l = 0; l < FUZZY_LANES; ++l)
+		{
+			any = any || (hit[l] != 0);
+		}
+
+		if (!any)
+		{
+			continue;
+		}
+
+		// The padding masks are 0, they never hit.
+		for (int l = 0; l < FUZZY_LANES; ++l)
+		{
+			if (hit[l] != 0)
+			{
+				out.push_back((uint32_t)(i + l));
+			}
+		}
+	}
+}
+
+
+void FuzzyMatch(FuzzyFilter& filter, char const* const query, std::vector<uint32_t>& ranked)
+{
+	ASSERT_DBG(query);
+
+	size_t const n = filter.offsets.size();
+
+	std::string q;
+
+	for (char const* s = query; *s != '\0'; ++s)
+	{
+		q += (char)tolower((unsigned char)*s);
+	}
+
+	ranked.clear();
+
+	if (q.empty())
+	{
+		for (size_t i = 0; i < n; ++i)
+		{
+			ranked.push_back((uint32_t)i);
+		}
+
+		filter.cached = false;
+		return;
+	}
+
+	uint64_t const qmask = FuzzyMask(q.c_str());
+
+	// Matches of "ab" are a subset of the matches of "a".
+	bool const refine = filter.cached && q.compare(0, filter.query.size(), filter.query) == 0;
+
+	std::vector<uint32_t> tested;
+
+	if (refine)
+	{
+		for (uint32_t const id : filter.candidates)
+		{
+			if ((filter.masks[id] & qmask) == qmask)
+			{
+				tested.push_back(id);
+			}
+		}
+	}
+	else
+	{
+		FuzzyPrefilter(filter, qmask, tested);
+	}
+
+	std::vector<FuzzyScored> scored;
+
+	filter.candidates.clear();
+
+	for (uint32_t const id : tested)
+	{
+		char const* const name = filter.text.c_str() + filter.offsets[id];
+
+		int score = 0;
+
+		if (FuzzyScore(name, q, &score))
+		{
+			uint32_t const end = (id + 1 < n) ? filter.offsets[id + 1] : (uint32_t)filter.text.size();
+
+			scored.push_back({ score, end - filter.offsets[id] - 1, id });
+			filter.candidates.push_back(id);
+		}
+	}
+
+	filter.query = q;
+	filter.cached = true;
+
+	// The shorter name first, then the order of the list.
+	std::sort(scored.begin(), scored.end(), [](FuzzyScored const& a, FuzzyScored const& b) {
+		if (a.score != b.score)
+		{
+			return a.score > b.score;
+		}
+
+		if (a.length != b.length)
+		{
+			return a.length < b.length;
+		}
+
+		return a.id < b.id;
+	});
+
+	ranked.reserve(scored.size());
+
+	for (FuzzyScored const& s : scored)
+	{
+		ranked.push_back(s.id);
+	}
+}
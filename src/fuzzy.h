@@ -0,0 +1,49 @@
+/*
+	Copyright 2026 Daniel T. Borelli <danieltborelli@gmail.com>
+
+	This file is part of xrunit.
+
+	xrunit is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	xrunit is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with xrunit.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef FUZZY_H_INCLUDE
+#define FUZZY_H_INCLUDE
+
+/*
+ * Ranked fuzzy filter over a list of names: a name matches when it
+ * has the characters of the query in order. Each name keeps a mask
+ * of the characters it has, tested a block of names at a time before
+ * the real match. When the query only grows, the previous matches
+ * are refined instead of scanning all the names again.
+ * Does not use fltk.
+ */
+
+struct FuzzyFilter
+{
+	std::string text;                /* the names in lowercase, NUL separated */
+	std::vector<uint32_t> offsets;
+	std::vector<uint64_t> masks;     /* padded with 0 to a block */
+	std::string query;               /* of 'candidates', if 'cached' */
+	std::vector<uint32_t> candidates;
+	bool cached;
+};
+
+void FuzzyClear(FuzzyFilter& filter);
+
+void FuzzyAdd(FuzzyFilter& filter, char const* const name);
+
+/* Indexes of the names that match, best first; all of them if 'query' is empty. */
+void FuzzyMatch(FuzzyFilter& filter, char const* const query, std::vector<uint32_t>& ranked);
+
+#endif
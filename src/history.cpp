@@ -0,0 +1,148 @@
+/*
+	Copyright 2026 Daniel T. Borelli <danieltborelli@gmail.com>
+
+	This file is part of xrunit.
+
+	xrunit is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	xrunit is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with xrunit.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "config.h"
+#include "status.h"
+#include "history.h"
+
+/* Only the transitions of the last seconds count. */
+#define HISTORY_WINDOW 120
+
+/* Starts inside the window for a crash loop. */
+#define HISTORY_CRASH_STARTS 3
+
+/* Transitions inside the window for a flapping service. */
+#define HISTORY_FLAP_CHANGES 6
+
+
+void HistoryClear(StateHistory& history)
+{
+	memset(&history, 0, sizeof(history));
+}
+
+
+static StateTransition const& HistoryAt(StateHistory const& history, int const back)
+{
+	ASSERT_DBG(back >= 0 && back < history.count);
+
+	return history.ring[(history.head + HISTORY_SZ - 1 - back) % HISTORY_SZ];
+}
+
+
+void HistoryRecord(StateHistory& history, SuperviseStatus const& st)
+{
+	// Nothing is known of the service.
+	if (st.state == STATE_FAIL)
+	{
+		return;
+	}
+
+	if (history.count > 0)
+	{
+		StateTransition const& last = HistoryAt(history, 0);
+
+		if (last.since == st.since && last.state == st.state && last.pid == st.pid)
+		{
+			return;
+		}
+	}
+
+	StateTransition& t = history.ring[history.head];
+
+	t.since = st.since;
+	t.pid = st.pid;
+	t.state = (int8_t)st.state;
+
+	history.head = (history.head + 1) % HISTORY_SZ;
+
+	if (history.count < HISTORY_SZ)
+	{
+		++history.count;
+	}
+}
+
+
+int HistoryCheck(StateHistory const& history, time_t const now, std::string& text)
+{
+	text.clear();
+
+	int starts = 0;
+	int changes = 0;
+
+	for (int i = 0; i < history.count; ++i)
+	{
+		StateTransition const& t = HistoryAt(history, i);
+
+		if (now - t.since > HISTORY_WINDOW)
+		{
+			break;
+		}
+
+		++changes;
+
+		if (t.state == STATE_RUN)
+		{
+			++starts;
+		}
+	}
+
+	int result = HISTORY_OK;
+	char buffer[STR_SZ];
+
+	if (starts >= HISTORY_CRASH_STARTS)
+	{
+		result = HISTORY_CRASH_LOOP;
+		snprintf(buffer, STR_SZ, "Crash loop: started %d times in the last %ds", starts, HISTORY_WINDOW);
+	}
+	else if (changes >= HISTORY_FLAP_CHANGES)
+	{
+		result = HISTORY_FLAP;
+		snprintf(buffer, STR_SZ, "Flapping: %d state changes in the last %ds", changes, HISTORY_WINDOW);
+	}
+
+	if (result == HISTORY_OK)
+	{
+		return result;
+	}
+
+	text = buffer;
+
+	for (int i = 0; i < history.count; ++i)
+	{
+		StateTransition const& t = HistoryAt(history, i);
+
+		struct tm tm;
+		char stamp[16];
+
+		localtime_r(&t.since, &tm);
+		strftime(stamp, sizeof(stamp), "%H:%M:%S", &tm);
+
+		if (t.pid != 0)
+		{
+			snprintf(buffer, STR_SZ, "\n%s %s (pid %d)", stamp, StatusStateName(t.state), (int)t.pid);
+		}
+		else
+		{
+			snprintf(buffer, STR_SZ, "\n%s %s", stamp, StatusStateName(t.state));
+		}
+
+		text += buffer;
+	}
+
+	return result;
+}
@@ -0,0 +1,62 @@
+/*
+	Copyright 2026 Daniel T. Borelli <danieltborelli@gmail.com>
+
+	This file is part of xrunit.
+
+	xrunit is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	xrunit is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with xrunit.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef HISTORY_H_INCLUDE
+#define HISTORY_H_INCLUDE
+
+/*
+ * Last state transitions of a service, in a fixed ring fed by each
+ * status read. runsv changes the time stamp of the status on each
+ * start and stop, so a restart between two reads is still recorded
+ * because 'since' changed, but the states it went through in between
+ * are not seen. Does not use fltk.
+ */
+
+#define HISTORY_SZ 8
+
+enum {
+	HISTORY_OK = 0,
+	/* started again and again */
+	HISTORY_CRASH_LOOP,
+	/* changing of state too often */
+	HISTORY_FLAP,
+};
+
+struct StateTransition
+{
+	time_t since;
+	pid_t pid;
+	int8_t state;
+};
+
+struct StateHistory
+{
+	StateTransition ring[HISTORY_SZ];
+	uint8_t head;       /* next to write */
+	uint8_t count;
+};
+
+void HistoryClear(StateHistory& history);
+
+void HistoryRecord(StateHistory& history, SuperviseStatus const& st);
+
+/* HISTORY_*, with the reason and the last transitions in 'text'. */
+int HistoryCheck(StateHistory const& history, time_t const now, std::string& text);
+
+#endif
@@ -0,0 +1,179 @@
+/*
+	Copyright 2026 Daniel T. Borelli <danieltborelli@gmail.com>
+
+	This file is part of xrunit.
+
+	xrunit is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	xrunit is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with xrunit.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "config.h"
+#include "launch.h"
+#include "perf.h"
+
+#include <spawn.h>
+
+static std::vector<std::string> launchEnv;
+static std::vector<char*> launchEnvp;
+static std::vector<std::string> launchPath;
+static std::unordered_map<std::string, std::string> launchFound;
+static bool launchReady = false;
+
+
+static void LaunchAddEnv(char const* const name, char const* const value)
+{
+	if (value == NULL || value[0] == '\0')
+	{
+		return;
+	}
+
+	launchEnv.push_back(std::string(name) + "=" + value);
+}
+
+
+void LaunchInit(void)
+{
+	if (launchReady)
+	{
+		return;
+	}
+
+	size_t const n = confstr(_CS_PATH, NULL, 0);
+
+	if (n == 0)
+	{
+		STOP("confstr(_CS_PATH, 0, 0) function failed");
+	}
+
+	std::string path(n, '\0');
+
+	if (confstr(_CS_PATH, &path[0], n) == 0)
+	{
+		STOP("confstr(_CS_PATH, pathbuf, n) function failed");
+	}
+
+	path.resize(n - 1);
+
+	LaunchAddEnv("PATH", path.c_str());
+	LaunchAddEnv("IFS", "\t\n");
+	LaunchAddEnv("DISPLAY", getenv("DISPLAY"));
+	LaunchAddEnv("XAUTHORITY", getenv("XAUTHORITY"));
+
+	// After the last push_back, the strings do not move anymore.
+	for (std::string& env : launchEnv)
+	{
+		launchEnvp.push_back(&env[0]);
+	}
+
+	launchEnvp.push_back(NULL);
+
+	for (size_t begin = 0; begin <= path.size(); )
+	{
+		size_t end = path.find(':', begin);
+
+		if (end == std::string::npos)
+		{
+			end = path.size();
+		}
+
+		launchPath.push_back((end > begin) ? path.substr(begin, end - begin) : ".");
+		begin = end + 1;
+	}
+
+	launchReady = true;
+}
+
+
+/* execvp looks in PATH of the child, posix_spawnp would look in the one of xrunit. */
+static char const* LaunchFind(char const* const exec)
+{
+	if (strchr(exec, '/') != NULL)
+	{
+		return exec;
+	}
+
+	auto const found = launchFound.find(exec);
+
+	if (found != launchFound.end())
+	{
+		return found->second.c_str();
+	}
+
+	for (std::string const& dir : launchPath)
+	{
+		std::string const file = dir + "/" + exec;
+
+		if (access(file.c_str(), X_OK) == 0)
+		{
+			return launchFound.emplace(exec, file).first->second.c_str();
+		}
+	}
+
+	return NULL;
+}
+
+
+pid_t LaunchSpawn(char const* const exec, char* const* argv, int const stdoutFd,
+		char const* const dir)
+{
+	ASSERT_DBG_STRING(exec);
+	ASSERT_DBG(argv);
+
+	LaunchInit();
+
+	char const* const file = LaunchFind(exec);
+
+	if (file == NULL)
+	{
+		errno = ENOENT;
+		return -1;
+	}
+
+	posix_spawn_file_actions_t actions;
+	posix_spawn_file_actions_t* actionsPtr = NULL;
+
+	if (stdoutFd != -1 || dir != NULL)
+	{
+		posix_spawn_file_actions_init(&actions);
+		actionsPtr = &actions;
+	}
+
+	if (stdoutFd != -1)
+	{
+		posix_spawn_file_actions_adddup2(&actions, stdoutFd, STDOUT_FILENO);
+	}
+
+	if (dir != NULL)
+	{
+		posix_spawn_file_actions_addchdir_np(&actions, dir);
+	}
+
+	pid_t pid = -1;
+
+	int const ret = posix_spawn(&pid, file, actionsPtr, NULL, argv, launchEnvp.data());
+
+	if (actionsPtr != NULL)
+	{
+		posix_spawn_file_actions_destroy(actionsPtr);
+	}
+
+	if (ret != 0)
+	{
+		errno = ret;
+		return -1;
+	}
+
+	PERF_COUNT(PERF_FORKS, 1);
+
+	return pid;
+}
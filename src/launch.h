@@ -0,0 +1,40 @@
+/*
+	Copyright 2026 Daniel T. Borelli <danieltborelli@gmail.com>
+
+	This file is part of xrunit.
+
+	xrunit is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	xrunit is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with xrunit.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef LAUNCH_H_INCLUDE
+#define LAUNCH_H_INCLUDE
+
+/*
+ * Every external command starts here, through posix_spawn: the child
+ * shares the memory of xrunit until its exec instead of copying the page
+ * tables of the whole GUI. The environment of the child is built once,
+ * PATH from confstr(_CS_PATH), IFS, DISPLAY and XAUTHORITY, and the one
+ * of xrunit is never changed.
+ */
+
+void LaunchInit(void);
+
+/*
+ * -1 and errno on failure. 'stdoutFd' != -1 becomes the stdout of the child,
+ * 'dir' != NULL its working directory.
+ */
+pid_t LaunchSpawn(char const* const exec, char* const* argv, int const stdoutFd,
+		char const* const dir);
+
+#endif
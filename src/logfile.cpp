@@ -0,0 +1,502 @@
+/*
+	Copyright 2026 Daniel T. Borelli <danieltborelli@gmail.com>
+
+	This file is part of xrunit.
+
+	xrunit is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	xrunit is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with xrunit.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "config.h"
+#include "logfile.h"
+
+#include <sys/mman.h>
+
+/* svlogd lines are short, a longer search back is cut here. */
+#define LOG_LINE_MAX (64 * 1024)
+
+/* TAI64 label of the unix epoch, see status.cpp */
+#define LOG_TAI64_UNIX_EPOCH 4611686018427387914ULL
+
+/* '@' + 16 hex digits of seconds + 8 of nanoseconds */
+#define LOG_TAI64N_SZ 25
+
+/* 2026-10-17_12:34:56 */
+#define LOG_DATE_SZ 19
+
+
+static bool LogFileIsLog(char const* const name)
+{
+	if (strcmp(name, LOG_CURRENT) == 0)
+	{
+		return true;
+	}
+
+	size_t const len = strlen(name);
+
+	return name[0] == '@' && len > 2 && name[len - 2] == '.'
+		&& (name[len - 1] == 's' || name[len - 1] == 'u');
+}
+
+
+static bool LogFileMap(LogFile& file, size_t const size)
+{
+	if (size == 0)
+	{
+		return true;
+	}
+
+	void* data = NULL;
+
+	errno = 0;
+
+	if (file.data == NULL)
+	{
+		data = mmap(NULL, size, PROT_READ, MAP_SHARED, file.fd, 0);
+	}
+	else
+	{
+		data = mremap((void*)file.data, file.size, size, MREMAP_MAYMOVE);
+	}
+
+	if (data == MAP_FAILED)
+	{
+		WARNING("mmap '%s' failed: %s", file.name.c_str(), strerror(errno));
+		return false;
+	}
+
+	file.data = (char const*)data;
+	file.size = size;
+
+	return true;
+}
+
+
+static bool LogFileOpen(int const dirfd, char const* const name, LogFile& file)
+{
+	file.name = name;
+	file.data = NULL;
+	file.size = 0;
+	file.base = 0;
+
+	errno = 0;
+
+	file.fd = openat(dirfd, name, O_RDONLY | O_CLOEXEC);
+
+	if (file.fd == -1)
+	{
+		return false;
+	}
+
+	struct stat st;
+
+	if (fstat(file.fd, &st) == -1 || !S_ISREG(st.st_mode) || !LogFileMap(file, st.st_size))
+	{
+		close(file.fd);
+		return false;
+	}
+
+	file.ino = st.st_ino;
+
+	return true;
+}
+
+
+static void LogFileClose(LogFile& file)
+{
+	if (file.data != NULL)
+	{
+		munmap((void*)file.data, file.size);
+	}
+
+	if (file.fd != -1)
+	{
+		close(file.fd);
+	}
+
+	file.data = NULL;
+	file.fd = -1;
+}
+
+
+/* Rotated files first; 'current' is the last one. */
+static bool LogNameLess(std::string const& a, std::string const& b)
+{
+	bool const aCurrent = (a == LOG_CURRENT);
+	bool const bCurrent = (b == LOG_CURRENT);
+
+	if (aCurrent != bCurrent)
+	{
+		return bCurrent;
+	}
+
+	return a < b;
+}
+
+
+/* Log files of a svlogd directory in chronological order. */
+bool LogSetList(char const* const dir, std::vector<std::string>& names)
+{
+	ASSERT_DBG_STRING(dir);
+
+	names.clear();
+
+	errno = 0;
+
+	DIR* d = opendir(dir);
+
+	if (d == NULL)
+	{
+		return false;
+	}
+
+	struct dirent* ent;
+
+	while ((ent = readdir(d)) != NULL)
+	{
+		if (LogFileIsLog(ent->d_name))
+		{
+			names.push_back(ent->d_name);
+		}
+	}
+
+	closedir(d);
+
+	std::sort(names.begin(), names.end(), LogNameLess);
+
+	return true;
+}
+
+
+/* 'path' is a svlogd directory, or one log file. */
+bool LogSetOpen(char const* const path, LogSet& set)
+{
+	ASSERT_DBG_STRING(path);
+
+	LogSetClose(set);
+
+	set.dir = path;
+	set.single = false;
+
+	struct stat st;
+
+	errno = 0;
+
+	if (stat(path, &st) == -1)
+	{
+		return false;
+	}
+
+	std::vector<std::string> names;
+
+	int dirfd = AT_FDCWD;
+
+	if (S_ISREG(st.st_mode))
+	{
+		set.single = true;
+		names.push_back(path);
+	}
+	else if (!LogSetList(path, names) || (dirfd = open(path, O_RDONLY | O_DIRECTORY | O_CLOEXEC)) == -1)
+	{
+		return false;
+	}
+
+	for (std::string const& name : names)
+	{
+		LogFile file;
+
+		if (LogFileOpen(dirfd, name.c_str(), file))
+		{
+			set.files.push_back(file);
+		}
+	}
+
+	if (dirfd != AT_FDCWD)
+	{
+		close(dirfd);
+	}
+
+	set.size = 0;
+
+	for (LogFile& file : set.files)
+	{
+		file.base = set.size;
+		set.size += file.size;
+	}
+
+	return true;
+}
+
+
+void LogSetClose(LogSet& set)
+{
+	for (LogFile& file : set.files)
+	{
+		LogFileClose(file);
+	}
+
+	set.files.clear();
+	set.size = 0;
+}
+
+
+/*
+ * Maps what was appended to 'current', it costs the appended bytes.
+ * Returns the bytes added, or -1 when svlogd rotated or truncated
+ * 'current' and the set must be opened again.
+ */
+ssize_t LogSetGrow(LogSet& set)
+{
+	if (set.files.empty() || (!set.single && set.files.back().name != LOG_CURRENT))
+	{
+		return -1;
+	}
+
+	LogFile& file = set.files.back();
+
+	struct stat st, stPath;
+
+	std::string const path = set.single ? set.dir : set.dir + "/" LOG_CURRENT;
+
+	if (fstat(file.fd, &st) == -1 || stat(path.c_str(), &stPath) == -1
+		|| st.st_ino != stPath.st_ino || (size_t)st.st_size < file.size)
+	{
+		return -1;
+	}
+
+	size_t const added = st.st_size - file.size;
+
+	if (added == 0)
+	{
+		return 0;
+	}
+
+	if (!LogFileMap(file, st.st_size))
+	{
+		return -1;
+	}
+
+	set.size += added;
+
+	return added;
+}
+
+
+/* Index of the file with the byte 'off', empty files are skipped. */
+size_t LogSetLocate(LogSet const& set, size_t const off)
+{
+	ASSERT_DBG(off < set.size);
+
+	size_t lo = 0, hi = set.files.size();
+
+	/* last file with base <= off */
+	while (hi - lo > 1)
+	{
+		size_t const mid = (lo + hi) / 2;
+
+		if (set.files[mid].base <= off)
+		{
+			lo = mid;
+		}
+		else
+		{
+			hi = mid;
+		}
+	}
+
+	return lo;
+}
+
+
+/* Start of the line that contains 'off'. Lines do not cross files. */
+size_t LogSetLineStart(LogSet const& set, size_t const off)
+{
+	if (off >= set.size)
+	{
+		return set.size;
+	}
+
+	LogFile const& file = set.files[LogSetLocate(set, off)];
+
+	size_t const pos = off - file.base;
+	size_t const from = (pos > LOG_LINE_MAX) ? pos - LOG_LINE_MAX : 0;
+
+	char const* nl = (char const*)memrchr(file.data + from, '\n', pos - from);
+
+	if (nl == NULL)
+	{
+		return file.base + from;
+	}
+
+	return file.base + (nl - file.data) + 1;
+}
+
+
+size_t LogSetNextLine(LogSet const& set, size_t const off)
+{
+	size_t len = 0;
+
+	char const* const line = LogSetLine(set, off, &len);
+
+	if (line == NULL)
+	{
+		return set.size;
+	}
+
+	LogFile const& file = set.files[LogSetLocate(set, off)];
+
+	size_t const end = off + len;
+
+	if (end < file.base + file.size && line[len] == '\n')
+	{
+		return end + 1;
+	}
+
+	return end;
+}
+
+
+size_t LogSetPrevLine(LogSet const& set, size_t const off)
+{
+	if (off == 0)
+	{
+		return 0;
+	}
+
+	return LogSetLineStart(set, off - 1);
+}
+
+
+/*
+ * Line that starts at 'off', without the newline.
+ * The last line of a file may not have one yet.
+ */
+char const* LogSetLine(LogSet const& set, size_t const off, size_t* const len)
+{
+	ASSERT_DBG(len);
+
+	if (off >= set.size)
+	{
+		*len = 0;
+		return NULL;
+	}
+
+	LogFile const& file = set.files[LogSetLocate(set, off)];
+
+	size_t const pos = off - file.base;
+	size_t const max = std::min(file.size - pos, (size_t)LOG_LINE_MAX);
+
+	char const* const line = file.data + pos;
+	char const* const nl = (char const*)memchr(line, '\n', max);
+
+	*len = (nl != NULL) ? (size_t)(nl - line) : max;
+
+	return line;
+}
+
+
+static bool LogHex(char const* const str, int const n, unsigned long long* const value)
+{
+	*value = 0;
+
+	for (int i = 0; i < n; ++i)
+	{
+		char const c = str[i];
+		int digit;
+
+		if (c >= '0' && c <= '9')
+		{
+			digit = c - '0';
+		}
+		else if (c >= 'a' && c <= 'f')
+		{
+			digit = c - 'a' + 10;
+		}
+		else
+		{
+			return false;
+		}
+
+		*value = (*value << 4) | digit;
+	}
+
+	return true;
+}
+
+
+/*
+ * Time stamp that svlogd writes at the start of the line:
+ *   -t   @400000006512abcd1234abcd          TAI64N
+ *   -tt  2026-10-17_12:34:56.12345          UTC
+ *   -ttt 2026-10-17T12:34:56.123456789      UTC
+ */
+bool LogLineTime(char const* const line, size_t const len, struct timespec* const ts)
+{
+	ASSERT_DBG(ts);
+
+	if (len >= LOG_TAI64N_SZ && line[0] == '@')
+	{
+		unsigned long long sec = 0, nsec = 0;
+
+		if (!LogHex(line + 1, 16, &sec) || !LogHex(line + 17, 8, &nsec) || sec < LOG_TAI64_UNIX_EPOCH)
+		{
+			return false;
+		}
+
+		ts->tv_sec = (time_t)(sec - LOG_TAI64_UNIX_EPOCH);
+		ts->tv_nsec = (long)nsec;
+
+		return true;
+	}
+
+	if (len < LOG_DATE_SZ || (line[10] != '_' && line[10] != 'T'))
+	{
+		return false;
+	}
+
+	/* the line is not terminated, sscanf needs a string */
+	char date[LOG_DATE_SZ + 1];
+
+	memcpy(date, line, LOG_DATE_SZ);
+	date[LOG_DATE_SZ] = '\0';
+
+	struct tm tm;
+
+	memset(&tm, 0, sizeof(tm));
+
+	if (sscanf(date, "%4d-%2d-%2d%*c%2d:%2d:%2d", &tm.tm_year, &tm.tm_mon,
+		&tm.tm_mday, &tm.tm_hour, &tm.tm_min, &tm.tm_sec) != 6)
+	{
+		return false;
+	}
+
+	tm.tm_year -= 1900;
+	tm.tm_mon -= 1;
+
+	ts->tv_sec = timegm(&tm);
+	ts->tv_nsec = 0;
+
+	/* fraction: 5 digits with -tt, 9 with -ttt */
+	long scale = 100000000L;
+
+	for (size_t i = LOG_DATE_SZ + 1; i < len && line[LOG_DATE_SZ] == '.' && scale > 0; ++i, scale /= 10)
+	{
+		if (line[i] < '0' || line[i] > '9')
+		{
+			break;
+		}
+
+		ts->tv_nsec += (line[i] - '0') * scale;
+	}
+
+	return true;
+}
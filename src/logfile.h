@@ -0,0 +1,72 @@
+/*
+	Copyright 2026 Daniel T. Borelli <danieltborelli@gmail.com>
+
+	This file is part of xrunit.
+
+	xrunit is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	xrunit is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with xrunit.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef LOGFILE_H_INCLUDE
+#define LOGFILE_H_INCLUDE
+
+/*
+ * The files of one svlogd directory mapped in memory: the rotated
+ * '@*.s' and '@*.u' in order of their TAI64N name, and 'current'.
+ * They are seen as one text, an offset is a byte position in it;
+ * no line index is built, only the bytes around an offset are read.
+ * One file, like an exported merge, can be opened as a set too.
+ * Does not use fltk.
+ */
+
+#define LOG_CURRENT "current"
+
+struct LogFile
+{
+	std::string name;
+	int fd;
+	char const* data;   /* NULL when empty */
+	size_t size;
+	size_t base;        /* offset of the first byte */
+	ino_t ino;
+};
+
+struct LogSet
+{
+	std::string dir;
+	std::vector<LogFile> files;
+	size_t size;
+	bool single;        /* 'dir' is one file */
+};
+
+bool LogSetList(char const* const dir, std::vector<std::string>& names);
+
+bool LogSetOpen(char const* const path, LogSet& set);
+
+void LogSetClose(LogSet& set);
+
+ssize_t LogSetGrow(LogSet& set);
+
+size_t LogSetLocate(LogSet const& set, size_t const off);
+
+size_t LogSetLineStart(LogSet const& set, size_t const off);
+
+size_t LogSetNextLine(LogSet const& set, size_t const off);
+
+size_t LogSetPrevLine(LogSet const& set, size_t const off);
+
+char const* LogSetLine(LogSet const& set, size_t const off, size_t* const len);
+
+bool LogLineTime(char const* const line, size_t const len, struct timespec* const ts);
+
+#endif
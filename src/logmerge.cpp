@@ -0,0 +1,285 @@
+/*
+	Copyright 2026 Daniel T. Borelli <danieltborelli@gmail.com>
+
+	This file is part of xrunit.
+
+	xrunit is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	xrunit is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with xrunit.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "config.h"
+#include "logfile.h"
+#include "logmerge.h"
+
+/* Read buffer of each stream; a longer line is cut. */
+#define LOG_MERGE_BUFFER (64 * 1024)
+
+#define LOG_MERGE_PROGRESS 20000
+
+struct LogStream
+{
+	std::string const* name;
+	std::string dir;
+	std::vector<std::string> files;
+	size_t file;            /* next file to open */
+	int fd;
+	char* buffer;
+	size_t start;           /* unread bytes: start..end */
+	size_t end;
+	char const* line;       /* current line, inside buffer */
+	size_t len;
+	size_t stamp;           /* length of the time stamp of the line, 0 if none */
+	struct timespec time;   /* of the last line with a stamp */
+};
+
+/* Min-heap of stream indexes by time; ties keep the order of the services. */
+struct LogStreamLater
+{
+	std::vector<LogStream> const* streams;
+
+	bool operator()(size_t const a, size_t const b) const
+	{
+		struct timespec const& ta = (*streams)[a].time;
+		struct timespec const& tb = (*streams)[b].time;
+
+		if (ta.tv_sec != tb.tv_sec)
+		{
+			return ta.tv_sec > tb.tv_sec;
+		}
+
+		if (ta.tv_nsec != tb.tv_nsec)
+		{
+			return ta.tv_nsec > tb.tv_nsec;
+		}
+
+		return a > b;
+	}
+};
+
+
+/*
+ * Reads more of the current file, at its end the next one is opened.
+ * Returns the bytes read, 0 at the end of a file, -1 after the last one.
+ */
+static ssize_t LogStreamRead(LogStream& s)
+{
+	if (s.start > 0)
+	{
+		memmove(s.buffer, s.buffer + s.start, s.end - s.start);
+		s.end -= s.start;
+		s.start = 0;
+	}
+
+	while (s.fd == -1)
+	{
+		if (s.file >= s.files.size())
+		{
+			return -1;
+		}
+
+		std::string const path = s.dir + "/" + s.files[s.file++];
+
+		errno = 0;
+
+		s.fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+
+		if (s.fd == -1)
+		{
+			WARNING("Failed to open '%s': %s", path.c_str(), strerror(errno));
+			continue;
+		}
+
+		posix_fadvise(s.fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+	}
+
+	ssize_t n;
+
+	do
+	{
+		n = read(s.fd, s.buffer + s.end, LOG_MERGE_BUFFER - s.end);
+	}
+	while (n == -1 && errno == EINTR);
+
+	if (n <= 0)
+	{
+		close(s.fd);
+		s.fd = -1;
+		return 0;
+	}
+
+	s.end += n;
+
+	return n;
+}
+
+
+static bool LogStreamNext(LogStream& s)
+{
+	for (;;)
+	{
+		char const* const p = s.buffer + s.start;
+		size_t const avail = s.end - s.start;
+
+		char const* const nl = (char const*)memchr(p, '\n', avail);
+
+		if (nl != NULL)
+		{
+			s.line = p;
+			s.len = nl - p;
+			s.start += s.len + 1;
+			break;
+		}
+
+		if (avail == LOG_MERGE_BUFFER)
+		{
+			s.line = p;
+			s.len = avail;
+			s.start = s.end;
+			break;
+		}
+
+		ssize_t const n = LogStreamRead(s);
+
+		if (n > 0)
+		{
+			continue;
+		}
+
+		/* the last line of a file without a newline */
+		if (s.end > s.start)
+		{
+			s.line = s.buffer + s.start;
+			s.len = s.end - s.start;
+			s.start = s.end;
+			break;
+		}
+
+		if (n == -1)
+		{
+			return false;
+		}
+	}
+
+	/* A line without a stamp keeps the time of the previous one. */
+	s.stamp = 0;
+
+	if (LogLineTime(s.line, s.len, &s.time))
+	{
+		char const* const space = (char const*)memchr(s.line, ' ', s.len);
+		s.stamp = (space != NULL) ? (size_t)(space - s.line) : s.len;
+	}
+
+	return true;
+}
+
+
+/* "stamp service: text", the stamp stays first for the viewer and the search. */
+static bool LogMergeWrite(LogStream const& s, FILE* out, LogMergeResult& result)
+{
+	std::string const& name = *s.name;
+
+	size_t rest = 0;
+
+	if (s.stamp > 0)
+	{
+		fwrite(s.line, 1, s.stamp, out);
+		fputc(' ', out);
+		rest = (s.stamp < s.len) ? s.stamp + 1 : s.len;
+	}
+
+	fwrite(name.data(), 1, name.size(), out);
+	fputs(": ", out);
+	fwrite(s.line + rest, 1, s.len - rest, out);
+
+	result.lines += 1;
+	result.bytes += s.len + name.size() + 3;
+
+	return fputc('\n', out) != EOF;
+}
+
+
+bool LogMerge(std::vector<LogMergeInput> const& inputs, FILE* out, LogMergeResult& result,
+		LogMergeProgressCb progressCb, void* data)
+{
+	ASSERT_DBG(out);
+
+	result.lines = 0;
+	result.bytes = 0;
+
+	std::vector<LogStream> streams(inputs.size());
+	std::vector<size_t> heap;
+
+	LogStreamLater const later = { &streams };
+
+	for (size_t i = 0; i < inputs.size(); ++i)
+	{
+		LogStream& s = streams[i];
+
+		s.name = &inputs[i].name;
+		s.dir = inputs[i].dir;
+		s.file = 0;
+		s.fd = -1;
+		s.buffer = new char[LOG_MERGE_BUFFER];
+		s.start = s.end = 0;
+		s.time.tv_sec = 0;
+		s.time.tv_nsec = 0;
+
+		if (!LogSetList(s.dir.c_str(), s.files))
+		{
+			WARNING("Failed to list the log directory '%s': %s", s.dir.c_str(), strerror(errno));
+		}
+
+		if (LogStreamNext(s))
+		{
+			heap.push_back(i);
+		}
+	}
+
+	std::make_heap(heap.begin(), heap.end(), later);
+
+	bool ok = true;
+
+	while (!heap.empty() && ok)
+	{
+		std::pop_heap(heap.begin(), heap.end(), later);
+
+		LogStream& s = streams[heap.back()];
+
+		ok = LogMergeWrite(s, out, result);
+
+		if (progressCb != NULL && result.lines % LOG_MERGE_PROGRESS == 0)
+		{
+			progressCb(result, data);
+		}
+
+		if (LogStreamNext(s))
+		{
+			std::push_heap(heap.begin(), heap.end(), later);
+		}
+		else
+		{
+			heap.pop_back();
+		}
+	}
+
+	for (LogStream& s : streams)
+	{
+		if (s.fd != -1)
+		{
+			close(s.fd);
+		}
+
+		delete[] s.buffer;
+	}
+
+	return ok;
+}
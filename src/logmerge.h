@@ -0,0 +1,48 @@
+/*
+	Copyright 2026 Daniel T. Borelli <danieltborelli@gmail.com>
+
+	This file is part of xrunit.
+
+	xrunit is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	xrunit is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with xrunit.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef LOGMERGE_H_INCLUDE
+#define LOGMERGE_H_INCLUDE
+
+/*
+ * One timeline from the svlogd logs of several services: a k-way
+ * merge by time stamp over a stream per service. Each stream reads
+ * its files in order through a fixed buffer, the logs are never
+ * loaded whole. Does not use fltk.
+ */
+
+struct LogMergeInput
+{
+	std::string name;
+	std::string dir;
+};
+
+struct LogMergeResult
+{
+	size_t lines;
+	size_t bytes;
+};
+
+/* Called every LOG_MERGE_PROGRESS lines, a GUI can handle its events there. */
+typedef void (*LogMergeProgressCb)(LogMergeResult const& result, void* data);
+
+bool LogMerge(std::vector<LogMergeInput> const& inputs, FILE* out, LogMergeResult& result,
+		LogMergeProgressCb progressCb, void* data);
+
+#endif
@@ -0,0 +1,454 @@
+/*
+	Copyright 2026 Daniel T. Borelli <danieltborelli@gmail.com>
+
+	This file is part of xrunit.
+
+	xrunit is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	xrunit is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with xrunit.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "config.h"
+#include "logfile.h"
+#include "logsearch.h"
+
+#include <regex.h>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+/* One time stamp every LOG_INDEX_STEP bytes of a file. */
+#define LOG_INDEX_STEP (64 * 1024)
+
+/* Unit of work of the threads, cut at a line end. */
+#define LOG_SEARCH_CHUNK (4 * 1024 * 1024)
+
+#define LOG_SEARCH_THREADS_MAX 16
+
+struct LogIndexEntry
+{
+	size_t pos;
+	time_t time;
+};
+
+/* Sparse index of one file; rotated files do not change, 'current' only grows. */
+struct LogIndex
+{
+	ino_t ino;
+	size_t next;    /* next block to index */
+	std::vector<LogIndexEntry> entries;
+};
+
+struct LogChunk
+{
+	size_t set;
+	LogFile const* file;
+	size_t start;
+	size_t end;
+	std::vector<LogMatch> matches;   /* at most LOG_SEARCH_MAX + 1 */
+	bool done;
+};
+
+/*
+ * The chunks done from the first one on are summed in order; once they
+ * hold more than LOG_SEARCH_MAX matches the chunks after them are not
+ * needed, the first matches are kept whatever thread found them.
+ */
+struct LogSearchJob
+{
+	LogSearchQuery const* query;
+	std::vector<LogChunk> chunks;
+	std::atomic<size_t> next;
+	std::atomic<size_t> stop;        /* first chunk not needed */
+	std::mutex lock;
+	size_t ordered;                  /* chunks done from the first one */
+	size_t orderedFound;
+};
+
+static std::unordered_map<std::string, LogIndex> logIndexCache;
+
+
+static LogIndex const& LogIndexUpdate(LogSet const& set, LogFile const& file)
+{
+	LogIndex& index = logIndexCache[set.dir + "/" + file.name];
+
+	if (index.ino != file.ino || index.next > file.size + LOG_INDEX_STEP)
+	{
+		index.ino = file.ino;
+		index.next = 0;
+		index.entries.clear();
+	}
+
+	for (; index.next < file.size; index.next += LOG_INDEX_STEP)
+	{
+		size_t start = index.next;
+
+		if (start > 0)
+		{
+			char const* const nl = (char const*)memchr(file.data + start - 1, '\n', file.size - start + 1);
+
+			if (nl == NULL)
+			{
+				break;
+			}
+
+			start = nl - file.data + 1;
+		}
+
+		if (start >= file.size)
+		{
+			break;
+		}
+
+		struct timespec ts;
+
+		if (LogLineTime(file.data + start, file.size - start, &ts))
+		{
+			index.entries.push_back({ start, ts.tv_sec });
+		}
+	}
+
+	return index;
+}
+
+
+/* Bytes of the file that can have lines inside [from, to]. */
+static void LogIndexSeek(LogIndex const& index, LogFile const& file, LogSearchQuery const& query,
+		size_t* const start, size_t* const end)
+{
+	*start = 0;
+	*end = file.size;
+
+	if (query.from != 0)
+	{
+		/* last entry before 'from' */
+		for (size_t lo = 0, hi = index.entries.size(); lo < hi; )
+		{
+			size_t const mid = (lo + hi) / 2;
+
+			if (index.entries[mid].time < query.from)
+			{
+				*start = index.entries[mid].pos;
+				lo = mid + 1;
+			}
+			else
+			{
+				hi = mid;
+			}
+		}
+	}
+
+	if (query.to != 0)
+	{
+		/* first entry after 'to' */
+		for (size_t lo = 0, hi = index.entries.size(); lo < hi; )
+		{
+			size_t const mid = (lo + hi) / 2;
+
+			if (index.entries[mid].time > query.to)
+			{
+				*end = index.entries[mid].pos;
+				hi = mid;
+			}
+			else
+			{
+				lo = mid + 1;
+			}
+		}
+	}
+}
+
+
+static void LogSearchSplit(LogSearchJob& job, size_t const set, LogFile const& file, size_t start, size_t const end)
+{
+	while (start < end)
+	{
+		size_t stop = start + LOG_SEARCH_CHUNK;
+
+		if (stop >= end)
+		{
+			stop = end;
+		}
+		else
+		{
+			char const* const nl = (char const*)memchr(file.data + stop, '\n', end - stop);
+			stop = (nl != NULL) ? (size_t)(nl - file.data) + 1 : end;
+		}
+
+		LogChunk chunk;
+
+		chunk.set = set;
+		chunk.file = &file;
+		chunk.start = start;
+		chunk.end = stop;
+		chunk.done = false;
+
+		job.chunks.push_back(chunk);
+
+		start = stop;
+	}
+}
+
+
+static bool LogSearchTimeOk(LogSearchQuery const& query, char const* const line, size_t const len)
+{
+	if (query.from == 0 && query.to == 0)
+	{
+		return true;
+	}
+
+	struct timespec ts;
+
+	if (!LogLineTime(line, len, &ts))
+	{
+		return false;
+	}
+
+	return (query.from == 0 || ts.tv_sec >= query.from) && (query.to == 0 || ts.tv_sec <= query.to);
+}
+
+
+static void LogSearchMatch(LogChunk& chunk, char const* const line)
+{
+	LogMatch match;
+
+	match.set = chunk.set;
+	match.off = chunk.file->base + (line - chunk.file->data);
+
+	chunk.matches.push_back(match);
+}
+
+
+/* One more than kept tells the search was truncated. */
+static inline bool LogSearchMore(LogSearchJob const& job, size_t const i)
+{
+	return job.chunks[i].matches.size() <= LOG_SEARCH_MAX && i < job.stop;
+}
+
+
+static void LogSearchDone(LogSearchJob& job, size_t const i)
+{
+	std::lock_guard<std::mutex> guard(job.lock);
+
+	job.chunks[i].done = true;
+
+	while (job.ordered < job.stop && job.chunks[job.ordered].done)
+	{
+		job.orderedFound += job.chunks[job.ordered].matches.size();
+		++job.ordered;
+
+		if (job.orderedFound > LOG_SEARCH_MAX)
+		{
+			job.stop = job.ordered;
+		}
+	}
+}
+
+
+/* memmem finds the text, only the lines with a match are looked at. */
+static void LogSearchLiteral(LogSearchJob& job, size_t const i)
+{
+	LogChunk& chunk = job.chunks[i];
+	std::string const& text = job.query->text;
+
+	char const* p = chunk.file->data + chunk.start;
+	char const* const end = chunk.file->data + chunk.end;
+
+	while (p < end && LogSearchMore(job, i))
+	{
+		char const* const hit = (char const*)memmem(p, end - p, text.data(), text.size());
+
+		if (hit == NULL)
+		{
+			break;
+		}
+
+		char const* line = (char const*)memrchr(p, '\n', hit - p);
+		line = (line != NULL) ? line + 1 : p;
+
+		char const* lineEnd = (char const*)memchr(hit, '\n', end - hit);
+		lineEnd = (lineEnd != NULL) ? lineEnd : end;
+
+		if (LogSearchTimeOk(*job.query, line, lineEnd - line))
+		{
+			LogSearchMatch(chunk, line);
+		}
+
+		p = lineEnd + 1;
+	}
+}
+
+
+static void LogSearchRegex(LogSearchJob& job, size_t const i, regex_t const* const re)
+{
+	LogChunk& chunk = job.chunks[i];
+	char const* p = chunk.file->data + chunk.start;
+	char const* const end = chunk.file->data + chunk.end;
+
+	while (p < end && LogSearchMore(job, i))
+	{
+		char const* lineEnd = (char const*)memchr(p, '\n', end - p);
+		lineEnd = (lineEnd != NULL) ? lineEnd : end;
+
+		if (LogSearchTimeOk(*job.query, p, lineEnd - p))
+		{
+			regmatch_t pm[1];
+
+			pm[0].rm_so = 0;
+			pm[0].rm_eo = lineEnd - p;
+
+			if (regexec(re, p, 1, pm, REG_STARTEND) == 0)
+			{
+				LogSearchMatch(chunk, p);
+			}
+		}
+
+		p = lineEnd + 1;
+	}
+}
+
+
+/* glibc serializes regexec on one regex_t: each thread has its own. */
+static void LogSearchWorker(LogSearchJob* job, regex_t const* re)
+{
+	for (;;)
+	{
+		size_t const i = job->next++;
+
+		if (i >= job->stop)
+		{
+			break;
+		}
+
+		if (re != NULL)
+		{
+			LogSearchRegex(*job, i, re);
+		}
+		else
+		{
+			LogSearchLiteral(*job, i);
+		}
+
+		LogSearchDone(*job, i);
+	}
+}
+
+
+/*
+ * Matches are in order: set, file, offset.
+ * Returns false when the regular expression is not valid.
+ */
+bool LogSearch(std::vector<LogSet> const& sets, LogSearchQuery const& query,
+		LogSearchResult& result, std::string& error)
+{
+	ASSERT_DBG(!query.text.empty());
+
+	result.matches.clear();
+	result.truncated = false;
+	result.scanned = 0;
+
+	LogSearchJob job;
+
+	job.query = &query;
+	job.next = 0;
+	job.ordered = 0;
+	job.orderedFound = 0;
+
+	bool const timeRange = (query.from != 0 || query.to != 0);
+
+	for (size_t s = 0; s < sets.size(); ++s)
+	{
+		for (LogFile const& file : sets[s].files)
+		{
+			if (file.size == 0)
+			{
+				continue;
+			}
+
+			size_t start = 0, end = file.size;
+
+			if (timeRange)
+			{
+				LogIndexSeek(LogIndexUpdate(sets[s], file), file, query, &start, &end);
+			}
+
+			result.scanned += (end > start) ? end - start : 0;
+
+			LogSearchSplit(job, s, file, start, end);
+		}
+	}
+
+	job.stop = job.chunks.size();
+
+	size_t threads = std::thread::hardware_concurrency();
+
+	threads = std::max((size_t)1, std::min(std::min(threads, job.chunks.size()), (size_t)LOG_SEARCH_THREADS_MAX));
+
+	std::vector<regex_t> res(query.regex ? threads : 0);
+
+	int const flags = REG_EXTENDED | REG_NOSUB | REG_NEWLINE;
+
+	for (size_t i = 0; i < res.size(); ++i)
+	{
+		int const ret = regcomp(&res[i], query.text.c_str(), flags);
+
+		if (ret != 0)
+		{
+			char str[256];
+			regerror(ret, &res[i], str, sizeof(str));
+			error = str;
+
+			for (size_t j = 0; j < i; ++j)
+			{
+				regfree(&res[j]);
+			}
+
+			return false;
+		}
+	}
+
+	std::vector<std::thread> pool;
+
+	for (size_t i = 1; i < threads; ++i)
+	{
+		pool.push_back(std::thread(LogSearchWorker, &job, query.regex ? &res[i] : NULL));
+	}
+
+	LogSearchWorker(&job, query.regex ? &res[0] : NULL);
+
+	for (std::thread& t : pool)
+	{
+		t.join();
+	}
+
+	for (regex_t& re : res)
+	{
+		regfree(&re);
+	}
+
+	// The chunks before 'stop' were all scanned to their end or to their limit.
+	for (size_t i = 0; i < job.stop; ++i)
+	{
+		for (LogMatch const& match : job.chunks[i].matches)
+		{
+			if (result.matches.size() == LOG_SEARCH_MAX)
+			{
+				result.truncated = true;
+				return true;
+			}
+
+			result.matches.push_back(match);
+		}
+	}
+
+	return true;
+}
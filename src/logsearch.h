@@ -0,0 +1,56 @@
+/*
+	Copyright 2026 Daniel T. Borelli <danieltborelli@gmail.com>
+
+	This file is part of xrunit.
+
+	xrunit is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	xrunit is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with xrunit.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef LOGSEARCH_H_INCLUDE
+#define LOGSEARCH_H_INCLUDE
+
+/*
+ * Search of a literal or a regular expression in the lines of
+ * several LogSet, with an optional time range. The files are split
+ * in chunks scanned by a pool of threads. Does not use fltk.
+ */
+
+/* Matches kept, the rest are counted as truncated. */
+#define LOG_SEARCH_MAX 10000
+
+struct LogSearchQuery
+{
+	std::string text;
+	bool regex;     /* POSIX extended */
+	time_t from;    /* 0: no limit */
+	time_t to;      /* 0: no limit */
+};
+
+struct LogMatch
+{
+	size_t set;
+	size_t off;     /* start of the line in the LogSet */
+};
+
+struct LogSearchResult
+{
+	std::vector<LogMatch> matches;
+	bool truncated;
+	size_t scanned; /* bytes */
+};
+
+bool LogSearch(std::vector<LogSet> const& sets, LogSearchQuery const& query,
+		LogSearchResult& result, std::string& error);
+
+#endif
@@ -0,0 +1,497 @@
+/*
+	Copyright 2026 Daniel T. Borelli <danieltborelli@gmail.com>
+
+	This file is part of xrunit.
+
+	xrunit is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	xrunit is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with xrunit.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "config.h"
+#include "logfile.h"
+#include "logview.h"
+#include "searchpanel.h"
+
+#include <sys/inotify.h>
+
+/* The scrollbar works on a fraction of the bytes, not on lines. */
+#define LOG_VIEW_SCROLL_MAX 1000000
+
+#define LOG_VIEW_WHEEL_LINES 3
+
+/* Longer lines are cut when drawn. */
+#define LOG_VIEW_COLUMNS_MAX 1024
+
+#define LOG_VIEW_EVENTS (IN_MODIFY | IN_CREATE | IN_MOVED_TO | IN_MOVED_FROM | IN_DELETE)
+
+class LogView : public Fl_Widget
+{
+public:
+	LogView(int const x, int const y, int const w, int const h,
+			Fl_Scrollbar* scrollbar, Fl_Box* infoBox, Fl_Check_Button* followButton);
+
+	~LogView();
+
+	bool Open(char const* const dir);
+
+	void Follow(bool const follow);
+
+	void ScrollTo(size_t const off);
+
+	bool Single(void) const { return set.single; }
+
+	int handle(int event);
+
+	void draw(void);
+
+	static void SearchCb(Fl_Widget* w, void* data);
+
+private:
+	LogSet set;
+	size_t top;          /* offset of the first visible line */
+	bool follow;
+	int watchFd;
+	Fl_Scrollbar* bar;
+	Fl_Box* info;
+	Fl_Check_Button* followBtn;
+
+	int VisibleLines(void);
+	size_t EndTop(void);
+	void ScrollLines(int const n);
+	void Reopen(void);
+	void UpdateBar(void);
+	void UpdateInfo(void);
+
+	static void WatchCb(int fd, void* data);
+	static void ScrollbarCb(Fl_Widget* w, void* data);
+	static void FollowCb(Fl_Widget* w, void* data);
+};
+
+
+LogView::LogView(int const x, int const y, int const w, int const h,
+		Fl_Scrollbar* scrollbar, Fl_Box* infoBox, Fl_Check_Button* followButton)
+	: Fl_Widget(x, y, w, h), top(0), follow(true), watchFd(-1),
+	bar(scrollbar), info(infoBox), followBtn(followButton)
+{
+	set.size = 0;
+	set.single = false;
+
+	box(FL_DOWN_BOX);
+	color(FL_BACKGROUND2_COLOR);
+
+	bar->callback(ScrollbarCb, (void*)this);
+	followBtn->callback(FollowCb, (void*)this);
+	followBtn->value(1);
+}
+
+
+LogView::~LogView()
+{
+	if (watchFd != -1)
+	{
+		Fl::remove_fd(watchFd);
+		close(watchFd);
+	}
+
+	LogSetClose(set);
+}
+
+
+bool LogView::Open(char const* const dir)
+{
+	ASSERT_DBG_STRING(dir);
+
+	if (!LogSetOpen(dir, set))
+	{
+		return false;
+	}
+
+	watchFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+
+	if (watchFd != -1 && inotify_add_watch(watchFd, dir, LOG_VIEW_EVENTS) != -1)
+	{
+		Fl::add_fd(watchFd, FL_READ, WatchCb, (void*)this);
+	}
+	else
+	{
+		WARNING("inotify on '%s' failed, the log is not followed: %s", dir, strerror(errno));
+	}
+
+	UpdateInfo();
+
+	return true;
+}
+
+
+int LogView::VisibleLines(void)
+{
+	fl_font(FL_COURIER, FONT_SZ);
+
+	int const lines = (h() - 4) / fl_height();
+
+	return (lines > 0) ? lines : 1;
+}
+
+
+/* First line of the last page. */
+size_t LogView::EndTop(void)
+{
+	size_t off = set.size;
+
+	for (int i = VisibleLines(); i > 0 && off > 0; --i)
+	{
+		off = LogSetPrevLine(set, off);
+	}
+
+	return off;
+}
+
+
+void LogView::ScrollTo(size_t const off)
+{
+	size_t const end = EndTop();
+
+	top = (off >= end) ? end : LogSetLineStart(set, off);
+
+	UpdateBar();
+	redraw();
+}
+
+
+void LogView::ScrollLines(int const n)
+{
+	size_t off = top;
+
+	if (n < 0)
+	{
+		Follow(false);
+
+		for (int i = n; i < 0 && off > 0; ++i)
+		{
+			off = LogSetPrevLine(set, off);
+		}
+	}
+	else
+	{
+		for (int i = 0; i < n && off < set.size; ++i)
+		{
+			off = LogSetNextLine(set, off);
+		}
+	}
+
+	ScrollTo(off);
+}
+
+
+void LogView::Follow(bool const follow)
+{
+	this->follow = follow;
+	followBtn->value(follow ? 1 : 0);
+
+	if (follow)
+	{
+		ScrollTo(set.size);
+	}
+
+	UpdateInfo();
+}
+
+
+void LogView::UpdateBar(void)
+{
+	if (set.size == 0)
+	{
+		bar->value(0, 1, 0, 1);
+		return;
+	}
+
+	size_t bottom = top;
+
+	for (int i = VisibleLines(); i > 0 && bottom < set.size; --i)
+	{
+		bottom = LogSetNextLine(set, bottom);
+	}
+
+	unsigned long long const size = set.size;
+
+	int const pos = (int)(top * (unsigned long long)LOG_VIEW_SCROLL_MAX / size);
+	int const window = (int)((bottom - top) * (unsigned long long)LOG_VIEW_SCROLL_MAX / size);
+
+	bar->value(pos, (window > 0) ? window : 1, 0, LOG_VIEW_SCROLL_MAX);
+}
+
+
+void LogView::UpdateInfo(void)
+{
+	char str[128];
+
+	snprintf(str, sizeof(str), "%zu files, %.1f MB%s", set.files.size(),
+		set.size / (1024.0 * 1024.0), follow ? ", following 'current'" : "");
+
+	info->copy_label(str);
+}
+
+
+/* svlogd rotated 'current', or removed an old file. */
+void LogView::Reopen(void)
+{
+	std::string const dir = set.dir;
+
+	if (!LogSetOpen(dir.c_str(), set))
+	{
+		WARNING("Failed to open the log directory '%s': %s", dir.c_str(), strerror(errno));
+	}
+
+	ScrollTo(follow ? set.size : top);
+	UpdateInfo();
+}
+
+
+/* Only 'current' growing is the common case: map the new bytes. */
+void LogView::WatchCb(int fd, void* data)
+{
+	LogView* view = (LogView*)data;
+
+	alignas(struct inotify_event) char buffer[4096];
+
+	bool reopen = false;
+	bool grow = false;
+
+	ssize_t n;
+
+	while ((n = read(fd, buffer, sizeof(buffer))) > 0)
+	{
+		for (char* p = buffer; p < buffer + n; )
+		{
+			struct inotify_event const* ev = (struct inotify_event const*)p;
+
+			p += sizeof(struct inotify_event) + ev->len;
+
+			if (ev->mask & IN_Q_OVERFLOW)
+			{
+				reopen = true;
+			}
+			else if (ev->len == 0)
+			{
+				/* the watch is on one file */
+				grow = grow || (ev->mask & IN_MODIFY);
+			}
+			else if ((ev->mask & IN_MODIFY) && strcmp(ev->name, LOG_CURRENT) == 0)
+			{
+				grow = true;
+			}
+			else if (ev->name[0] == '@' || strcmp(ev->name, LOG_CURRENT) == 0)
+			{
+				reopen = true;
+			}
+		}
+	}
+
+	if (!reopen && grow)
+	{
+		ssize_t const added = LogSetGrow(view->set);
+
+		if (added == 0)
+		{
+			return;
+		}
+
+		reopen = (added == -1);
+
+		if (!reopen)
+		{
+			if (view->follow)
+			{
+				view->ScrollTo(view->set.size);
+			}
+			else
+			{
+				view->UpdateBar();
+			}
+
+			view->UpdateInfo();
+		}
+	}
+
+	if (reopen)
+	{
+		view->Reopen();
+	}
+}
+
+
+void LogView::ScrollbarCb(Fl_Widget* w, void* data)
+{
+	LogView* view = (LogView*)data;
+	Fl_Scrollbar* bar = (Fl_Scrollbar*)w;
+
+	size_t const off = (size_t)(bar->value() * (unsigned long long)view->set.size / LOG_VIEW_SCROLL_MAX);
+
+	view->Follow(false);
+	view->ScrollTo(off);
+}
+
+
+void LogView::FollowCb(Fl_Widget* w, void* data)
+{
+	((LogView*)data)->Follow(((Fl_Check_Button*)w)->value() != 0);
+}
+
+
+/* The service is the name of the log directory. */
+void LogView::SearchCb(UNUSED Fl_Widget* w, void* data)
+{
+	LogView* view = (LogView*)data;
+
+	std::string const& dir = view->set.dir;
+
+	SearchPanelShow(dir.c_str() + dir.rfind('/') + 1);
+}
+
+
+int LogView::handle(int event)
+{
+	switch (event)
+	{
+		case FL_PUSH:
+			take_focus();
+			return 1;
+		case FL_FOCUS:
+		case FL_UNFOCUS:
+			return 1;
+		case FL_MOUSEWHEEL:
+			ScrollLines(Fl::event_dy() * LOG_VIEW_WHEEL_LINES);
+			return 1;
+		case FL_KEYBOARD:
+			switch (Fl::event_key())
+			{
+				case FL_Up:
+					ScrollLines(-1);
+					return 1;
+				case FL_Down:
+					ScrollLines(1);
+					return 1;
+				case FL_Page_Up:
+					ScrollLines(-VisibleLines());
+					return 1;
+				case FL_Page_Down:
+					ScrollLines(VisibleLines());
+					return 1;
+				case FL_Home:
+					Follow(false);
+					ScrollTo(0);
+					return 1;
+				case FL_End:
+					Follow(true);
+					return 1;
+			}
+			break;
+	}
+
+	return Fl_Widget::handle(event);
+}
+
+
+/* Only the lines from 'top' to the bottom of the widget are read. */
+void LogView::draw(void)
+{
+	fl_draw_box(FL_DOWN_BOX, x(), y(), w(), h(), color());
+	fl_push_clip(x() + 2, y() + 2, w() - 4, h() - 4);
+
+	fl_font(FL_COURIER, FONT_SZ);
+	fl_color(FL_FOREGROUND_COLOR);
+
+	int const lineH = fl_height();
+
+	size_t off = top;
+
+	for (int ly = y() + 2 + lineH - fl_descent(); ly - lineH < y() + h() && off < set.size; ly += lineH)
+	{
+		size_t len = 0;
+
+		char const* const line = LogSetLine(set, off, &len);
+
+		fl_draw(line, (int)std::min(len, (size_t)LOG_VIEW_COLUMNS_MAX), x() + 4, ly);
+
+		off = LogSetNextLine(set, off);
+	}
+
+	fl_pop_clip();
+}
+
+
+static void LogViewCloseCb(Fl_Widget* w, UNUSED void* data)
+{
+	w->hide();
+	Fl::delete_widget(w);
+}
+
+
+void LogViewShow(char const* const dir, char const* const service, size_t const off)
+{
+	ASSERT_DBG_STRING(dir);
+	ASSERT_DBG_STRING(service);
+
+	Fl_Double_Window* wnd = new Fl_Double_Window(700, 450);
+
+	Fl_Check_Button* follow = new Fl_Check_Button(BTN_X, BTN_Y, BTN_W, BTN_H, "Follow");
+	follow->labelfont(FONT);
+	follow->labelsize(FONT_SZ);
+
+	Fl_Box* info = new Fl_Box(BTN_X + BTN_W + BTN_PAD, BTN_Y, wnd->w() - BTN_W * 2 - BTN_PAD * 2 - 20, BTN_H);
+	info->align(Fl_Align(FL_ALIGN_LEFT | FL_ALIGN_INSIDE));
+	info->labelfont(FONT);
+	info->labelsize(FONT_SZ);
+
+	Fl_Scrollbar* bar = new Fl_Scrollbar(wnd->w() - 20, 40, 16, wnd->h() - 44);
+
+	LogView* view = new LogView(4, 40, wnd->w() - 24, wnd->h() - 44, bar, info, follow);
+
+	Fl_Button* search = new Fl_Button(wnd->w() - BTN_W - BTN_X, BTN_Y, BTN_W, BTN_H, "Search...");
+	search->labelfont(FONT);
+	search->labelsize(FONT_SZ);
+	search->callback(LogView::SearchCb, (void*)view);
+
+	wnd->resizable(view);
+	wnd->end();
+
+	if (!view->Open(dir))
+	{
+		fl_alert("Failed to open the log directory: %s\nError:%s", dir, strerror(errno));
+		delete wnd;
+		return;
+	}
+
+	if (view->Single())
+	{
+		search->deactivate();
+	}
+
+	std::string title = TITLE " - Log: ";
+	title += service;
+
+	wnd->copy_label(title.c_str());
+	wnd->callback(LogViewCloseCb);
+	wnd->show();
+
+	view->take_focus();
+
+	if (off == LOG_VIEW_FOLLOW)
+	{
+		view->Follow(true);
+	}
+	else
+	{
+		view->Follow(false);
+		view->ScrollTo(off);
+	}
+}
@@ -0,0 +1,33 @@
+/*
+	Copyright 2026 Daniel T. Borelli <danieltborelli@gmail.com>
+
+	This file is part of xrunit.
+
+	xrunit is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	xrunit is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with xrunit.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef LOGVIEW_H_INCLUDE
+#define LOGVIEW_H_INCLUDE
+
+/*
+ * Window with the svlogd logs of a service. Only the visible lines
+ * are drawn from the mapped files, 'current' is followed with inotify.
+ */
+
+/* Offset of the first line shown, or the end and following it. */
+#define LOG_VIEW_FOLLOW ((size_t)-1)
+
+void LogViewShow(char const* const dir, char const* const service, size_t const off);
+
+#endif
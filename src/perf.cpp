@@ -0,0 +1,162 @@
+/*
+	Copyright 2026 Daniel T. Borelli <danieltborelli@gmail.com>
+
+	This file is part of xrunit.
+
+	xrunit is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	xrunit is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with xrunit.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "config.h"
+#include "perf.h"
+
+/* Samples kept per phase for the percentiles. */
+#define PERF_SAMPLES 128
+
+struct PerfPhase
+{
+	double samples[PERF_SAMPLES];
+	size_t next;
+	size_t size;
+	double pending;
+};
+
+static char const* const PERF_PHASE_NAME[PERF_PHASE_MAX] = {
+	[PERF_SCAN] = "scan",
+	[PERF_REGISTRY] = "registry",
+	[PERF_IGNORE] = "ignore",
+	[PERF_ROWS] = "rows",
+	[PERF_PROC] = "proc",
+	[PERF_REDRAW] = "redraw",
+	[PERF_COMMAND] = "command",
+};
+
+bool perfEnabled = false;
+
+static PerfPhase perfPhase[PERF_PHASE_MAX];
+
+static unsigned long perfCounter[PERF_COUNTER_MAX];
+
+
+double PerfNow(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (double)ts.tv_sec * 1e3 + (double)ts.tv_nsec / 1e6;
+}
+
+
+double PerfSeconds(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+
+void PerfSample(int const phase, double const ms)
+{
+	ASSERT_DBG(phase >= 0 && phase < PERF_PHASE_MAX);
+
+	PerfPhase& p = perfPhase[phase];
+
+	p.samples[p.next] = ms;
+	p.next = (p.next + 1) % PERF_SAMPLES;
+
+	if (p.size < PERF_SAMPLES)
+	{
+		++p.size;
+	}
+}
+
+
+void PerfAdd(int const phase, double const ms)
+{
+	ASSERT_DBG(phase >= 0 && phase < PERF_PHASE_MAX);
+	perfPhase[phase].pending += ms;
+}
+
+
+void PerfCommit(int const phase)
+{
+	ASSERT_DBG(phase >= 0 && phase < PERF_PHASE_MAX);
+	PerfSample(phase, perfPhase[phase].pending);
+	perfPhase[phase].pending = 0.0;
+}
+
+
+void PerfCount(int const counter, unsigned long const n)
+{
+	ASSERT_DBG(counter >= 0 && counter < PERF_COUNTER_MAX);
+
+	// StatusScanRoots counts from its threads.
+	__atomic_fetch_add(&perfCounter[counter], n, __ATOMIC_RELAXED);
+}
+
+
+/* Enabling starts from zero. */
+void PerfEnable(bool const enable)
+{
+	memset(perfPhase, 0, sizeof(perfPhase));
+	memset(perfCounter, 0, sizeof(perfCounter));
+	perfEnabled = enable;
+}
+
+
+static double PerfPercentile(PerfPhase const& p, double* const sorted, int const percent)
+{
+	size_t const k = (p.size - 1) * percent / 100;
+
+	std::nth_element(sorted, sorted + k, sorted + p.size);
+
+	return sorted[k];
+}
+
+
+/* "scan 0.31/1.20 ... ms (p50/p99) | forks 3 ..." */
+void PerfFormat(std::string& str)
+{
+	char buffer[64];
+
+	str.clear();
+
+	for (int i = 0; i < PERF_PHASE_MAX; ++i)
+	{
+		PerfPhase const& p = perfPhase[i];
+
+		if (p.size == 0)
+		{
+			continue;
+		}
+
+		double sorted[PERF_SAMPLES];
+
+		memcpy(sorted, p.samples, p.size * sizeof(double));
+
+		double const p50 = PerfPercentile(p, sorted, 50);
+		double const p99 = PerfPercentile(p, sorted, 99);
+
+		snprintf(buffer, sizeof(buffer), "%s %.2f/%.2f  ", PERF_PHASE_NAME[i], p50, p99);
+		str += buffer;
+	}
+
+	if (!str.empty())
+	{
+		str += "ms (p50/p99) | ";
+	}
+
+	snprintf(buffer, sizeof(buffer), "refresh %lu  forks %lu  read %lu KB  rows %lu",
+		perfCounter[PERF_REFRESHES], perfCounter[PERF_FORKS],
+		perfCounter[PERF_BYTES_READ] / 1024, perfCounter[PERF_ROWS_CHANGED]);
+
+	str += buffer;
+}
@@ -0,0 +1,92 @@
+/*
+	Copyright 2026 Daniel T. Borelli <danieltborelli@gmail.com>
+
+	This file is part of xrunit.
+
+	xrunit is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	xrunit is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with xrunit.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef PERF_H_INCLUDE
+#define PERF_H_INCLUDE
+
+/*
+ * Timings and counters of the refresh phases and the commands.
+ * Always compiled; when disabled each macro is one test of 'perfEnabled'.
+ * Does not use fltk.
+ */
+
+enum {
+	PERF_SCAN = 0,      /* StatusScan */
+	PERF_REGISTRY,      /* RegistryUpdateStatus, RegistryScan */
+	PERF_IGNORE,        /* FindIgnoreService */
+	PERF_ROWS,          /* browser rows and icons */
+	PERF_PROC,          /* /proc sampling of the services */
+	PERF_REDRAW,        /* main window flush */
+	PERF_COMMAND,       /* batch of sv commands, start to last result */
+	PERF_PHASE_MAX,
+};
+
+enum {
+	PERF_FORKS = 0,
+	PERF_BYTES_READ,
+	PERF_ROWS_CHANGED,
+	PERF_REFRESHES,
+	PERF_COUNTER_MAX,
+};
+
+extern bool perfEnabled;
+
+#define PERF_BEGIN(Start)                                   \
+	double const Start = perfEnabled ? PerfNow() : 0.0
+
+/* A Start of 0.0 began while disabled (F12 enabled it meanwhile): no sample. */
+#define PERF_END(Phase, Start)                              \
+	do {                                                    \
+		if (perfEnabled && (Start) != 0.0) PerfSample(Phase, PerfNow() - (Start)); \
+	} while(0)
+
+/* Several intervals of one phase, PERF_COMMIT adds them as one sample. */
+#define PERF_ADD(Phase, Start)                              \
+	do {                                                    \
+		if (perfEnabled && (Start) != 0.0) PerfAdd(Phase, PerfNow() - (Start)); \
+	} while(0)
+
+#define PERF_COMMIT(Phase)                                  \
+	do {                                                    \
+		if (perfEnabled) PerfCommit(Phase);                 \
+	} while(0)
+
+#define PERF_COUNT(Counter, N)                              \
+	do {                                                    \
+		if (perfEnabled) PerfCount(Counter, N);             \
+	} while(0)
+
+double PerfNow(void);
+
+/* The same monotonic clock in seconds, for the rates and timeouts of other modules. */
+double PerfSeconds(void);
+
+void PerfSample(int const phase, double const ms);
+
+void PerfAdd(int const phase, double const ms);
+
+void PerfCommit(int const phase);
+
+void PerfCount(int const counter, unsigned long const n);
+
+void PerfEnable(bool const enable);
+
+void PerfFormat(std::string& str);
+
+#endif
@@ -0,0 +1,310 @@
+/*
+	Copyright 2026 Daniel T. Borelli <danieltborelli@gmail.com>
+
+	This file is part of xrunit.
+
+	xrunit is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	xrunit is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with xrunit.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "config.h"
+#include "procstat.h"
+#include "perf.h"
+
+#include <atomic>
+#include <thread>
+#include <sys/resource.h>
+
+/* Below this the jobs are done in the caller thread. */
+#define PROC_THREAD_MIN 512
+
+#define PROC_THREAD_MAX 8
+
+#define PROC_BUFFER_SZ 1024
+
+/* Descriptors left for the rest of the program. */
+#define PROC_FDS_RESERVE 256
+
+/* Descriptors kept open between samples, from RLIMIT_NOFILE. */
+static std::atomic<long> procFdsCached(0);
+static long procFdsMax = -1;
+
+
+void ProcStatInit(ProcStat& ps)
+{
+	memset(&ps, 0, sizeof(ps));
+	ps.fdStat = ps.fdStatm = ps.fdIo = ps.fdDir = -1;
+}
+
+
+static void ProcCloseFd(int& fd)
+{
+	if (fd != -1)
+	{
+		close(fd);
+		fd = -1;
+	}
+}
+
+
+static void ProcStatCloseFds(ProcStat& ps)
+{
+	if (ps.fdStat != -1)
+	{
+		procFdsCached -= 4;
+	}
+
+	ProcCloseFd(ps.fdStat);
+	ProcCloseFd(ps.fdStatm);
+	ProcCloseFd(ps.fdIo);
+	ProcCloseFd(ps.fdDir);
+}
+
+
+void ProcStatClose(ProcStat& ps)
+{
+	ProcStatCloseFds(ps);
+	ProcStatInit(ps);
+}
+
+
+static int ProcOpen(pid_t const pid, char const* const name, int const flags)
+{
+	char path[64];
+
+	snprintf(path, sizeof(path), "/proc/%d/%s", (int)pid, name);
+
+	return open(path, flags | O_CLOEXEC);
+}
+
+
+static bool ProcStatOpen(ProcStat& ps, pid_t const pid)
+{
+	ps.fdStat = ProcOpen(pid, "stat", O_RDONLY);
+	ps.fdStatm = ProcOpen(pid, "statm", O_RDONLY);
+	ps.fdIo = ProcOpen(pid, "io", O_RDONLY);
+	ps.fdDir = ProcOpen(pid, "fd", O_RDONLY | O_DIRECTORY);
+
+	// 'io' and 'fd' can be denied, 'stat' is needed.
+	if (ps.fdStat == -1)
+	{
+		ProcCloseFd(ps.fdStatm);
+		ProcCloseFd(ps.fdIo);
+		ProcCloseFd(ps.fdDir);
+		return false;
+	}
+
+	procFdsCached += 4;
+
+	return true;
+}
+
+
+static ssize_t ProcRead(int const fd, char* buffer)
+{
+	if (fd == -1)
+	{
+		return -1;
+	}
+
+	ssize_t const n = pread(fd, buffer, PROC_BUFFER_SZ - 1, 0);
+
+	buffer[(n > 0) ? n : 0] = '\0';
+
+	return n;
+}
+
+
+/* Linux 6.2 gives the count as the size of the directory. */
+static int ProcCountFds(int const fdDir)
+{
+	if (fdDir == -1)
+	{
+		return 0;
+	}
+
+	struct stat st;
+
+	if (fstat(fdDir, &st) == 0 && st.st_size > 0)
+	{
+		return (int)st.st_size;
+	}
+
+	int const fd = openat(fdDir, ".", O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+
+	DIR* dir = (fd != -1) ? fdopendir(fd) : NULL;
+
+	if (dir == NULL)
+	{
+		if (fd != -1)
+		{
+			close(fd);
+		}
+
+		return 0;
+	}
+
+	int n = 0;
+
+	for (struct dirent* ent = readdir(dir); ent != NULL; ent = readdir(dir))
+	{
+		n += (ent->d_name[0] != '.');
+	}
+
+	closedir(dir);
+
+	return n;
+}
+
+
+static void ProcSample(ProcStat& ps, pid_t const pid)
+{
+	// Another process, the previous sample is of no use.
+	if (pid != ps.pid)
+	{
+		ProcStatClose(ps);
+		ps.pid = pid;
+	}
+
+	if (pid == 0)
+	{
+		return;
+	}
+
+	bool const cache = (procFdsCached + 4 <= procFdsMax);
+
+	if (ps.fdStat == -1 && !ProcStatOpen(ps, pid))
+	{
+		ProcStatClose(ps);
+		return;
+	}
+
+	char buffer[PROC_BUFFER_SZ];
+
+	// The name may have spaces and ')', the fields start after the last one.
+	if (ProcRead(ps.fdStat, buffer) <= 0)
+	{
+		// The process exited, its descriptors are of no use.
+		ProcStatClose(ps);
+		return;
+	}
+
+	char const* p = strrchr(buffer, ')');
+
+	unsigned long long utime = 0, stime = 0;
+	long threads = 0;
+
+	// state(3) ... utime(14) stime(15) ... num_threads(20)
+	if (p == NULL || sscanf(p + 2, "%*c %*d %*d %*d %*d %*d %*u %*u %*u %*u %*u %llu %llu %*d %*d %*d %*d %ld",
+		&utime, &stime, &threads) != 3)
+	{
+		ProcStatClose(ps);
+		return;
+	}
+
+	unsigned long long resident = 0;
+
+	if (ProcRead(ps.fdStatm, buffer) > 0)
+	{
+		sscanf(buffer, "%*u %llu", &resident);
+	}
+
+	unsigned long long readBytes = 0, writeBytes = 0;
+
+	if (ProcRead(ps.fdIo, buffer) > 0)
+	{
+		char const* r = strstr(buffer, "\nread_bytes: ");
+		char const* w = strstr(buffer, "\nwrite_bytes: ");
+
+		readBytes = (r != NULL) ? strtoull(r + 13, NULL, 10) : 0;
+		writeBytes = (w != NULL) ? strtoull(w + 14, NULL, 10) : 0;
+	}
+
+	double const now = PerfSeconds();
+	unsigned long long const ticks = utime + stime;
+
+	if (ps.valid && now > ps.when && ticks >= ps.ticks)
+	{
+		double const dt = now - ps.when;
+
+		ps.cpu = (ticks - ps.ticks) * 100.0 / sysconf(_SC_CLK_TCK) / dt;
+		ps.readRate = (readBytes >= ps.readBytes) ? (readBytes - ps.readBytes) / dt : 0.0;
+		ps.writeRate = (writeBytes >= ps.writeBytes) ? (writeBytes - ps.writeBytes) / dt : 0.0;
+	}
+
+	ps.valid = true;
+	ps.when = now;
+	ps.ticks = ticks;
+	ps.readBytes = readBytes;
+	ps.writeBytes = writeBytes;
+	ps.rss = resident * (unsigned long long)sysconf(_SC_PAGESIZE);
+	ps.threads = (int)threads;
+	ps.fds = ProcCountFds(ps.fdDir);
+
+	// Over the budget the descriptors are opened on each sample.
+	if (!cache)
+	{
+		ProcStatCloseFds(ps);
+	}
+}
+
+
+static void ProcSampleRange(std::vector<ProcJob> const& jobs, size_t const begin, size_t const end)
+{
+	for (size_t i = begin; i < end; ++i)
+	{
+		ProcSample(*jobs[i].ps, jobs[i].pid);
+	}
+}
+
+
+void ProcSampleAll(std::vector<ProcJob> const& jobs)
+{
+	if (procFdsMax == -1)
+	{
+		struct rlimit rl;
+
+		procFdsMax = 0;
+
+		if (getrlimit(RLIMIT_NOFILE, &rl) == 0 && rl.rlim_cur != RLIM_INFINITY)
+		{
+			procFdsMax = std::max(0L, (long)rl.rlim_cur - PROC_FDS_RESERVE);
+		}
+	}
+
+	size_t const n = jobs.size();
+
+	size_t const threads = std::min((size_t)PROC_THREAD_MAX,
+		std::min((size_t)std::thread::hardware_concurrency(), n / PROC_THREAD_MIN));
+
+	if (threads <= 1)
+	{
+		ProcSampleRange(jobs, 0, n);
+		return;
+	}
+
+	std::vector<std::thread> workers;
+
+	size_t const step = (n + threads - 1) / threads;
+
+	for (size_t begin = step; begin < n; begin += step)
+	{
+		workers.emplace_back(ProcSampleRange, std::cref(jobs), begin, std::min(begin + step, n));
+	}
+
+	ProcSampleRange(jobs, 0, step);
+
+	for (std::thread& t : workers)
+	{
+		t.join();
+	}
+}
@@ -0,0 +1,64 @@
+/*
+	Copyright 2026 Daniel T. Borelli <danieltborelli@gmail.com>
+
+	This file is part of xrunit.
+
+	xrunit is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	xrunit is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with xrunit.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef PROCSTAT_H_INCLUDE
+#define PROCSTAT_H_INCLUDE
+
+/*
+ * CPU, memory, threads, open files and disk I/O of a process, read
+ * from /proc/<pid>/{stat,statm,io,fd} with pread on descriptors kept
+ * open between samples. Rates come from the previous sample.
+ * Does not use fltk.
+ */
+
+struct ProcStat
+{
+	pid_t pid;          /* of the samples, 0 if none */
+	int fdStat;
+	int fdStatm;
+	int fdIo;
+	int fdDir;          /* /proc/<pid>/fd */
+	bool valid;         /* the previous sample exists */
+	double when;        /* of the previous sample, seconds */
+	unsigned long long ticks;
+	unsigned long long readBytes;
+	unsigned long long writeBytes;
+	/* results of the last sample */
+	double cpu;         /* percent of one cpu */
+	double readRate;    /* bytes per second */
+	double writeRate;
+	unsigned long long rss; /* bytes */
+	int threads;
+	int fds;
+};
+
+struct ProcJob
+{
+	ProcStat* ps;
+	pid_t pid;          /* 0 closes the descriptors */
+};
+
+void ProcStatInit(ProcStat& ps);
+
+void ProcStatClose(ProcStat& ps);
+
+/* Every job once, in worker threads when there are many. */
+void ProcSampleAll(std::vector<ProcJob> const& jobs);
+
+#endif
@@ -0,0 +1,275 @@
+/*
+	Copyright 2026 Daniel T. Borelli <danieltborelli@gmail.com>
+
+	This file is part of xrunit.
+
+	xrunit is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	xrunit is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with xrunit.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "config.h"
+#include "proctree.h"
+#include "perf.h"
+
+#include <ctype.h>
+
+#define PROC_STAT_SZ 1024
+
+static std::unordered_map<pid_t, ProcNode> procNodes;
+
+static unsigned int procPass = 0;
+
+/* of the last pass, seconds; -1 before the first one */
+static double procWhen = -1.0;
+
+
+static bool ProcTreeLink(pid_t const pid, pid_t const ppid)
+{
+	auto const it = procNodes.find(ppid);
+
+	if (it == procNodes.end())
+	{
+		return false;
+	}
+
+	it->second.children.push_back(pid);
+
+	return true;
+}
+
+
+static void ProcTreeUnlink(pid_t const pid, pid_t const ppid)
+{
+	auto const it = procNodes.find(ppid);
+
+	if (it == procNodes.end())
+	{
+		return;
+	}
+
+	std::vector<pid_t>& children = it->second.children;
+
+	auto const child = std::find(children.begin(), children.end(), pid);
+
+	if (child != children.end())
+	{
+		*child = children.back();
+		children.pop_back();
+	}
+}
+
+
+/* The fields of /proc/<pid>/stat, false if the process exited. */
+static bool ProcTreeRead(pid_t const pid, ProcNode& node)
+{
+	char path[64];
+	char buffer[PROC_STAT_SZ];
+
+	snprintf(path, sizeof(path), "/proc/%d/stat", (int)pid);
+
+	int const fd = open(path, O_RDONLY | O_CLOEXEC);
+
+	if (fd == -1)
+	{
+		return false;
+	}
+
+	ssize_t const n = read(fd, buffer, sizeof(buffer) - 1);
+
+	close(fd);
+
+	if (n <= 0)
+	{
+		return false;
+	}
+
+	buffer[n] = '\0';
+
+	char const* const first = strchr(buffer, '(');
+	char const* const last = strrchr(buffer, ')');
+
+	if (first == NULL || last == NULL || last < first)
+	{
+		return false;
+	}
+
+	size_t const len = std::min((size_t)(last - first - 1), (size_t)PROC_COMM_SZ - 1);
+
+	memcpy(node.comm, first + 1, len);
+	node.comm[len] = '\0';
+
+	int ppid = 0;
+	unsigned long long utime = 0, stime = 0, start = 0;
+	long rss = 0;
+
+	// state(3) ppid(4) ... utime(14) stime(15) ... starttime(22) vsize(23) rss(24)
+	if (sscanf(last + 2, "%*c %d %*d %*d %*d %*d %*u %*u %*u %*u %*u %llu %llu %*d %*d %*d %*d %*d %*d %llu %*u %ld",
+		&ppid, &utime, &stime, &start, &rss) != 5)
+	{
+		return false;
+	}
+
+	node.ppid = ppid;
+	node.ticks = utime + stime;
+	node.start = start;
+	node.rss = (unsigned long long)std::max(rss, 0L) * (unsigned long long)sysconf(_SC_PAGESIZE);
+
+	return true;
+}
+
+
+void ProcTreeUpdate(double const maxAge)
+{
+	double const now = PerfSeconds();
+
+	if (procWhen >= 0.0 && now - procWhen < maxAge)
+	{
+		return;
+	}
+
+	DIR* dir = opendir("/proc");
+
+	if (dir == NULL)
+	{
+		WARNING("opendir /proc failed: %s", strerror(errno));
+		return;
+	}
+
+	double const dt = (procWhen >= 0.0) ? now - procWhen : 0.0;
+	double const tick = (double)sysconf(_SC_CLK_TCK);
+
+	++procPass;
+
+	// Read before a new parent, they are linked after the pass.
+	std::vector<pid_t> pending;
+
+	for (struct dirent* ent = readdir(dir); ent != NULL; ent = readdir(dir))
+	{
+		if (!isdigit((unsigned char)ent->d_name[0]))
+		{
+			continue;
+		}
+
+		pid_t const pid = (pid_t)atoi(ent->d_name);
+
+		ProcNode next;
+
+		if (!ProcTreeRead(pid, next))
+		{
+			continue;
+		}
+
+		auto const it = procNodes.find(pid);
+
+		if (it == procNodes.end() || it->second.start != next.start)
+		{
+			if (it != procNodes.end())
+			{
+				// A reused pid: its children linked earlier in this pass stay, the
+				// ones of the old process move away when their ppid changes.
+				ProcTreeUnlink(pid, it->second.ppid);
+				next.children = std::move(it->second.children);
+				procNodes.erase(it);
+			}
+
+			next.cpu = 0.0;
+			next.pass = procPass;
+			procNodes.emplace(pid, next);
+
+			if (!ProcTreeLink(pid, next.ppid))
+			{
+				pending.push_back(pid);
+			}
+
+			continue;
+		}
+
+		ProcNode& node = it->second;
+
+		if (node.ppid != next.ppid)
+		{
+			ProcTreeUnlink(pid, node.ppid);
+			node.ppid = next.ppid;
+
+			if (!ProcTreeLink(pid, next.ppid))
+			{
+				pending.push_back(pid);
+			}
+		}
+
+		node.cpu = (dt > 0.0 && next.ticks >= node.ticks) ? (next.ticks - node.ticks) * 100.0 / tick / dt : 0.0;
+		node.ticks = next.ticks;
+		node.rss = next.rss;
+		node.pass = procPass;
+		memcpy(node.comm, next.comm, PROC_COMM_SZ);
+	}
+
+	closedir(dir);
+
+	for (pid_t const pid : pending)
+	{
+		ProcTreeLink(pid, procNodes[pid].ppid);
+	}
+
+	for (auto it = procNodes.begin(); it != procNodes.end(); )
+	{
+		if (it->second.pass != procPass)
+		{
+			ProcTreeUnlink(it->first, it->second.ppid);
+			it = procNodes.erase(it);
+		}
+		else
+		{
+			++it;
+		}
+	}
+
+	procWhen = now;
+}
+
+
+ProcNode const* ProcTreeFind(pid_t const pid)
+{
+	auto const it = procNodes.find(pid);
+
+	return (it != procNodes.end()) ? &it->second : NULL;
+}
+
+
+bool ProcTreeSum(pid_t const pid, ProcTreeTotal& total)
+{
+	total.cpu = 0.0;
+	total.rss = 0;
+	total.procs = 0;
+
+	if (ProcTreeFind(pid) == NULL)
+	{
+		return false;
+	}
+
+	std::vector<pid_t> stack(1, pid);
+
+	while (!stack.empty())
+	{
+		ProcNode const& node = procNodes[stack.back()];
+
+		stack.pop_back();
+
+		total.cpu += node.cpu;
+		total.rss += node.rss;
+		++total.procs;
+
+		stack.insert(stack.end(), node.children.begin(), node.children.end());
+	}
+
+	return true;
+}
@@ -0,0 +1,59 @@
+/*
+	Copyright 2026 Daniel T. Borelli <danieltborelli@gmail.com>
+
+	This file is part of xrunit.
+
+	xrunit is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	xrunit is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with xrunit.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef PROCTREE_H_INCLUDE
+#define PROCTREE_H_INCLUDE
+
+/*
+ * Index parent -> children of all the processes, from one pass over
+ * /proc. Between passes only the processes that appeared, exited or
+ * changed of parent are moved in the index.
+ * Does not use fltk.
+ */
+
+#define PROC_COMM_SZ 16
+
+struct ProcNode
+{
+	pid_t ppid;
+	unsigned long long start;  /* starttime, another process with a reused pid */
+	unsigned long long ticks;  /* utime + stime */
+	unsigned long long rss;    /* bytes */
+	double cpu;                /* percent of one cpu since the previous pass */
+	unsigned int pass;         /* last pass that saw it */
+	char comm[PROC_COMM_SZ];
+	std::vector<pid_t> children;
+};
+
+struct ProcTreeTotal
+{
+	double cpu;
+	unsigned long long rss;
+	int procs;
+};
+
+/* A pass over /proc, unless the last one is newer than 'maxAge' seconds. */
+void ProcTreeUpdate(double const maxAge);
+
+ProcNode const* ProcTreeFind(pid_t const pid);
+
+/* 'pid' and all its descendants. */
+bool ProcTreeSum(pid_t const pid, ProcTreeTotal& total);
+
+#endif
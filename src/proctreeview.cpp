@@ -0,0 +1,210 @@
+/*
+	Copyright 2026 Daniel T. Borelli <danieltborelli@gmail.com>
+
+	This file is part of xrunit.
+
+	xrunit is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	xrunit is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with xrunit.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "config.h"
+#include "status.h"
+#include "history.h"
+#include "procstat.h"
+#include "registry.h"
+#include "proctree.h"
+#include "proctreeview.h"
+
+struct ProcTreeView
+{
+	Fl_Double_Window* wnd;
+	Fl_Tree* tree;
+	Fl_Box* info;
+	std::string service;
+	std::unordered_set<pid_t> closed;  /* survive the rebuild */
+};
+
+
+static void ProcTreeLabel(ProcNode const& node, pid_t const pid, std::string& label)
+{
+	char str[128];
+
+	// '/' separates the path of the items in Fl_Tree.
+	snprintf(str, sizeof(str), "%d %s  %.1f%%  %.1f MB", (int)pid, node.comm,
+		node.cpu, node.rss / (1024.0 * 1024.0));
+
+	label = str;
+
+	std::replace(label.begin(), label.end(), '/', '|');
+}
+
+
+static void ProcTreeAdd(ProcTreeView* view, Fl_Tree_Item* parent, pid_t const pid)
+{
+	ProcNode const* node = ProcTreeFind(pid);
+
+	if (node == NULL)
+	{
+		return;
+	}
+
+	std::string label;
+
+	ProcTreeLabel(*node, pid, label);
+
+	Fl_Tree_Item* item = (parent == NULL) ? view->tree->add(label.c_str()) : view->tree->add(parent, label.c_str());
+
+	if (item == NULL)
+	{
+		return;
+	}
+
+	item->user_data((void*)(intptr_t)pid);
+
+	for (pid_t const child : node->children)
+	{
+		ProcTreeAdd(view, item, child);
+	}
+
+	if (view->closed.count(pid) > 0)
+	{
+		item->close();
+	}
+}
+
+
+static void ProcTreeFill(ProcTreeView* view)
+{
+	ProcTreeUpdate(TIME_PROC / 2.0);
+
+	size_t const id = RegistryFind(view->service.c_str());
+
+	pid_t pid = 0;
+
+	if (id != REGISTRY_NONE)
+	{
+		Service const& srv = RegistryAt(id);
+
+		pid = (srv.state == STATE_RUN) ? srv.pid : 0;
+	}
+
+	// The rebuild keeps the scroll.
+	int const top = view->tree->vposition();
+
+	view->tree->clear();
+
+	ProcTreeTotal total;
+
+	if (pid == 0 || !ProcTreeSum(pid, total))
+	{
+		view->info->copy_label("The service is not running.");
+		view->tree->redraw();
+		return;
+	}
+
+	ProcTreeAdd(view, NULL, pid);
+
+	char str[128];
+
+	snprintf(str, sizeof(str), "%d processes, %.1f%% cpu, %.1f MB", total.procs, total.cpu,
+		total.rss / (1024.0 * 1024.0));
+
+	view->info->copy_label(str);
+	view->tree->vposition(top);
+	view->tree->redraw();
+}
+
+
+static void ProcTreeTimerCb(void* data)
+{
+	ProcTreeFill((ProcTreeView*)data);
+	Fl::repeat_timeout(TIME_PROC, ProcTreeTimerCb, data);
+}
+
+
+/* Only the closed items are remembered, new processes are shown open. */
+static void ProcTreeItemCb(Fl_Widget* w, void* data)
+{
+	ProcTreeView* view = (ProcTreeView*)data;
+	Fl_Tree* tree = (Fl_Tree*)w;
+	Fl_Tree_Item* item = tree->callback_item();
+
+	if (item == NULL)
+	{
+		return;
+	}
+
+	pid_t const pid = (pid_t)(intptr_t)item->user_data();
+
+	switch (tree->callback_reason())
+	{
+		case FL_TREE_REASON_CLOSED:
+			view->closed.insert(pid);
+			break;
+		case FL_TREE_REASON_OPENED:
+			view->closed.erase(pid);
+			break;
+		default:
+			break;
+	}
+}
+
+
+static void ProcTreeCloseCb(Fl_Widget* w, void* data)
+{
+	ProcTreeView* view = (ProcTreeView*)data;
+
+	Fl::remove_timeout(ProcTreeTimerCb, data);
+
+	w->hide();
+	Fl::delete_widget(w);
+
+	delete view;
+}
+
+
+void ProcTreeShow(char const* const service)
+{
+	ASSERT_DBG_STRING(service);
+
+	ProcTreeView* view = new ProcTreeView;
+
+	view->service = service;
+
+	view->wnd = new Fl_Double_Window(460, 380);
+
+	view->info = new Fl_Box(BTN_X, BTN_Y, view->wnd->w() - BTN_X * 2, BTN_H);
+	view->info->align(Fl_Align(FL_ALIGN_LEFT | FL_ALIGN_INSIDE));
+	view->info->labelfont(FONT);
+	view->info->labelsize(FONT_SZ);
+
+	view->tree = new Fl_Tree(4, 40, view->wnd->w() - 8, view->wnd->h() - 44);
+	view->tree->showroot(0);
+	view->tree->item_labelfont(FONT);
+	view->tree->item_labelsize(FONT_SZ);
+	view->tree->callback(ProcTreeItemCb, (void*)view);
+
+	view->wnd->resizable(view->tree);
+	view->wnd->end();
+
+	std::string title = TITLE " - Processes: ";
+	title += service;
+
+	view->wnd->copy_label(title.c_str());
+	view->wnd->callback(ProcTreeCloseCb, (void*)view);
+	view->wnd->show();
+
+	ProcTreeFill(view);
+
+	Fl::add_timeout(TIME_PROC, ProcTreeTimerCb, (void*)view);
+}
@@ -0,0 +1,30 @@
+/*
+	Copyright 2026 Daniel T. Borelli <danieltborelli@gmail.com>
+
+	This file is part of xrunit.
+
+	xrunit is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	xrunit is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with xrunit.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef PROCTREEVIEW_H_INCLUDE
+#define PROCTREEVIEW_H_INCLUDE
+
+/*
+ * Window with the processes of a running service as an expandable
+ * tree, refreshed every TIME_PROC from the index of proctree.
+ */
+
+void ProcTreeShow(char const* const service);
+
+#endif
@@ -0,0 +1,240 @@
+/*
+	Copyright 2026 Daniel T. Borelli <danieltborelli@gmail.com>
+
+	This file is part of xrunit.
+
+	xrunit is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	xrunit is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with xrunit.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "config.h"
+#include "system.h"
+#include "status.h"
+#include "history.h"
+#include "procstat.h"
+#include "registry.h"
+
+#define REGISTRY_SLOTS_MIN 64
+
+static std::vector<Service> services;
+
+/* Slots with the index in 'services' plus one, 0 is empty. */
+static std::vector<size_t> slots(REGISTRY_SLOTS_MIN, 0);
+
+static char const* scanSvDir = NULL;
+
+
+static size_t RegistrySlot(char const* const name)
+{
+	size_t const mask = slots.size() - 1;
+
+	size_t i = Hash(name) & mask;
+
+	while (slots[i] != 0 && services[slots[i] - 1].name != name)
+	{
+		i = (i + 1) & mask;
+	}
+
+	return i;
+}
+
+
+static void RegistryRehash(size_t const size)
+{
+	size_t n = REGISTRY_SLOTS_MIN;
+
+	/* Load factor <= 0.5 */
+	while (n < size * 2)
+	{
+		n <<= 1;
+	}
+
+	slots.assign(n, 0);
+
+	for (size_t id = 0; id < services.size(); ++id)
+	{
+		slots[RegistrySlot(services[id].name.c_str())] = id + 1;
+	}
+}
+
+
+size_t RegistryFind(char const* const name)
+{
+	ASSERT_DBG_STRING(name);
+
+	size_t const slot = slots[RegistrySlot(name)];
+
+	return (slot == 0) ? REGISTRY_NONE : slot - 1;
+}
+
+
+size_t RegistryAdd(char const* const name)
+{
+	ASSERT_DBG_STRING(name);
+
+	size_t i = RegistrySlot(name);
+
+	if (slots[i] != 0)
+	{
+		return slots[i] - 1;
+	}
+
+	services.push_back(Service());
+
+	Service& srv = services.back();
+	srv.name = name;
+	srv.state = -1;
+	srv.pid = 0;
+	srv.listLine = 0;
+	srv.available = false;
+	srv.linked = false;
+	srv.down = false;
+	srv.logDown = false;
+	srv.seen = false;
+	srv.root = 0;
+	HistoryClear(srv.history);
+	ProcStatInit(srv.proc);
+
+	size_t const id = services.size() - 1;
+
+	if (services.size() * 2 > slots.size())
+	{
+		RegistryRehash(services.size());
+	}
+	else
+	{
+		slots[i] = id + 1;
+	}
+
+	return id;
+}
+
+
+size_t RegistrySize(void)
+{
+	return services.size();
+}
+
+
+Service& RegistryAt(size_t const id)
+{
+	ASSERT_DBG(id < services.size());
+	return services[id];
+}
+
+
+static void RegistryScanSvDir(char const* path)
+{
+	Service& srv = services[RegistryAdd(path)];
+
+	srv.available = true;
+	srv.seen = true;
+
+	std::string file = scanSvDir;
+	file += "/";
+	file += path;
+	file += "/down";
+
+	struct stat st;
+
+	srv.down = (stat(file.c_str(), &st) == 0);
+
+	file.erase(file.size() - 4);
+	file += "log/down";
+
+	srv.logDown = (stat(file.c_str(), &st) == 0);
+}
+
+
+static void RegistryScanRunDir(char const* path)
+{
+	Service& srv = services[RegistryAdd(path)];
+
+	srv.linked = true;
+	srv.seen = true;
+}
+
+
+/*
+ * Rebuilds the directory flags; the services that are gone are removed.
+ * Those of the other run directories are kept, RegistryUpdateStatus has them.
+ */
+void RegistryScan(char const* const svDir, char const* const runDir)
+{
+	ASSERT_DBG_STRING(svDir);
+	ASSERT_DBG_STRING(runDir);
+
+	for (Service& srv : services)
+	{
+		srv.available = false;
+		srv.linked = (srv.root > 0);
+		srv.seen = (srv.root > 0);
+	}
+
+	scanSvDir = svDir;
+
+	ListDirectories(svDir, RegistryScanSvDir);
+	ListDirectories(runDir, RegistryScanRunDir);
+
+	scanSvDir = NULL;
+
+	size_t const size = services.size();
+
+	for (size_t i = 0; i < services.size(); )
+	{
+		if (!services[i].seen)
+		{
+			// Its cached /proc descriptors would leak under the one moved in.
+			ProcStatClose(services[i].proc);
+			services[i] = std::move(services.back());
+			services.pop_back();
+		}
+		else
+		{
+			++i;
+		}
+	}
+
+	if (size != services.size())
+	{
+		RegistryRehash(services.size());
+	}
+}
+
+
+void RegistryUpdateStatus(StatusSnapshot const& snap)
+{
+	for (Service& srv : services)
+	{
+		srv.state = -1;
+		srv.pid = 0;
+	}
+
+	for (ServiceStatus const& st : snap)
+	{
+		RegistrySetStatus(st);
+	}
+}
+
+
+void RegistrySetStatus(ServiceStatus const& st)
+{
+	Service& srv = services[RegistryAdd(st.name.c_str())];
+
+	srv.linked = true;
+	srv.seen = true;
+	srv.root = st.root;
+	srv.state = st.srv.state;
+	srv.pid = st.srv.pid;
+
+	HistoryRecord(srv.history, st.srv);
+}
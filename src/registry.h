@@ -0,0 +1,60 @@
+/*
+	Copyright 2026 Daniel T. Borelli <danieltborelli@gmail.com>
+
+	This file is part of xrunit.
+
+	xrunit is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	xrunit is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with xrunit.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef REGISTRY_H_INCLUDE
+#define REGISTRY_H_INCLUDE
+
+/*
+ * All the known services, stored in one array and indexed
+ * by name with an open addressing hash table.
+ */
+
+#define REGISTRY_NONE ((size_t)-1)
+
+struct Service
+{
+	std::string name;
+	int state;          /* STATE_*, -1 when not in SV_RUN_DIR */
+	pid_t pid;
+	int listLine;       /* line in browser[LIST], 0 when not shown */
+	bool available;     /* SV_DIR/name */
+	bool linked;        /* SV_RUN_DIR/name */
+	bool down;          /* SV_DIR/name/down */
+	bool logDown;       /* SV_DIR/name/log/down */
+	bool seen;
+	int root;           /* ServiceStatus.root, the others are not in SV_DIR */
+	StateHistory history;
+	ProcStat proc;      /* of 'pid', while the resource columns are shown */
+};
+
+size_t RegistryFind(char const* const name);
+
+size_t RegistryAdd(char const* const name);
+
+size_t RegistrySize(void);
+
+Service& RegistryAt(size_t const id);
+
+void RegistryScan(char const* const svDir, char const* const runDir);
+
+void RegistryUpdateStatus(StatusSnapshot const& snap);
+
+void RegistrySetStatus(ServiceStatus const& st);
+
+#endif
@@ -0,0 +1,242 @@
+/*
+	Copyright 2026 Daniel T. Borelli <danieltborelli@gmail.com>
+
+	This file is part of xrunit.
+
+	xrunit is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	xrunit is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with xrunit.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "config.h"
+#include "savebatch.h"
+
+
+static bool WriteAll(int const fd, char const* data, size_t length)
+{
+	while (length > 0)
+	{
+		ssize_t const n = write(fd, data, length);
+
+		if (n == -1)
+		{
+			if (errno == EINTR)
+			{
+				continue;
+			}
+
+			return false;
+		}
+
+		data += n;
+		length -= n;
+	}
+
+	return true;
+}
+
+
+static void DirName(std::string const& path, std::string& dir)
+{
+	size_t const slash = path.rfind('/');
+
+	dir = (slash == std::string::npos) ? "." : path.substr(0, (slash == 0) ? 1 : slash);
+}
+
+
+static bool SyncDir(std::string const& dir)
+{
+	int const fd = open(dir.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+
+	if (fd == -1)
+	{
+		return false;
+	}
+
+	bool const ok = (fsync(fd) == 0);
+
+	close(fd);
+
+	return ok;
+}
+
+
+void SaveBatchInit(SaveBatch& batch)
+{
+	batch.files.clear();
+	batch.failed = false;
+	batch.replaced = 0;
+}
+
+
+bool SaveBatchAdd(SaveBatch& batch, std::string const& path,
+		char const* const data, size_t const length, bool const executable)
+{
+	ASSERT_DBG(!path.empty());
+	ASSERT_DBG(data != NULL || length == 0);
+
+	if (batch.failed)
+	{
+		return false;
+	}
+
+	struct stat st;
+
+	bool const exists = (stat(path.c_str(), &st) == 0);
+
+	mode_t mode = S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH;
+
+	if (executable)
+	{
+		mode |= S_IXUSR | S_IXGRP | S_IXOTH;
+	}
+	else if (exists)
+	{
+		mode = st.st_mode & 07777;
+	}
+
+	SaveBatchFile file;
+
+	file.path = path;
+	file.temp = path + ".xrunit-" + std::to_string(getpid());
+
+	errno = 0;
+
+	file.fd = open(file.temp.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, mode);
+
+	// Left by a save that died before its rename.
+	if (file.fd == -1 && errno == EEXIST)
+	{
+		unlink(file.temp.c_str());
+		file.fd = open(file.temp.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, mode);
+	}
+
+	if (file.fd == -1)
+	{
+		fl_alert("Failed to create file: %s\nError:%s", file.temp.c_str(), strerror(errno));
+		batch.failed = true;
+		return false;
+	}
+
+	batch.files.push_back(file);
+
+	// The umask must not take bits from the mode, the owner stays as it was.
+	bool ok = (fchmod(file.fd, mode) == 0);
+
+	if (ok && exists && geteuid() == 0 && (st.st_uid != 0 || st.st_gid != 0))
+	{
+		ok = (fchown(file.fd, st.st_uid, st.st_gid) == 0);
+	}
+
+	if (!ok || !WriteAll(file.fd, data, length))
+	{
+		fl_alert("Failed to write file: %s\nError:%s", file.temp.c_str(), strerror(errno));
+		batch.failed = true;
+		return false;
+	}
+
+	return true;
+}
+
+
+bool SaveBatchCommit(SaveBatch& batch)
+{
+	if (batch.failed)
+	{
+		SaveBatchAbort(batch);
+		return false;
+	}
+
+	for (SaveBatchFile& file : batch.files)
+	{
+		errno = 0;
+
+		if (fsync(file.fd) == -1)
+		{
+			fl_alert("Failed to write file: %s\nError:%s\n\nNothing was saved.",
+					file.path.c_str(), strerror(errno));
+			SaveBatchAbort(batch);
+			return false;
+		}
+	}
+
+	std::vector<std::string> dirs;
+	size_t replaced = 0;
+	bool ok = true;
+
+	for (SaveBatchFile& file : batch.files)
+	{
+		errno = 0;
+
+		if (rename(file.temp.c_str(), file.path.c_str()) == -1)
+		{
+			int const error = errno;
+			std::string done;
+
+			for (size_t i = 0; i < replaced; ++i)
+			{
+				done += "\n" + batch.files[i].path;
+			}
+
+			fl_alert("Failed to replace file: %s\nError:%s\n\n%s%s",
+					file.path.c_str(), strerror(error),
+					(replaced == 0) ? "Nothing was saved." : "Already replaced:",
+					done.c_str());
+			ok = false;
+			break;
+		}
+
+		close(file.fd);
+		file.fd = -1;
+		++replaced;
+
+		std::string dir;
+
+		DirName(file.path, dir);
+
+		if (std::find(dirs.begin(), dirs.end(), dir) == dirs.end())
+		{
+			dirs.push_back(dir);
+		}
+	}
+
+	for (std::string const& dir : dirs)
+	{
+		if (!SyncDir(dir))
+		{
+			WARNING("Failed to sync directory: %s, error=%s", dir.c_str(), strerror(errno));
+		}
+	}
+
+	// The files not renamed go with their temporaries.
+	batch.files.erase(batch.files.begin(), batch.files.begin() + replaced);
+	SaveBatchAbort(batch);
+	batch.replaced = replaced;
+
+	return ok;
+}
+
+
+void SaveBatchAbort(SaveBatch& batch)
+{
+	for (SaveBatchFile const& file : batch.files)
+	{
+		if (file.fd != -1)
+		{
+			close(file.fd);
+		}
+
+		unlink(file.temp.c_str());
+	}
+
+	SaveBatchInit(batch);
+}
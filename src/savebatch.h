@@ -0,0 +1,58 @@
+/*
+	Copyright 2026 Daniel T. Borelli <danieltborelli@gmail.com>
+
+	This file is part of xrunit.
+
+	xrunit is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	xrunit is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with xrunit.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef SAVEBATCH_H_INCLUDE
+#define SAVEBATCH_H_INCLUDE
+
+/*
+ * The files of a service saved all or none. Each one is written to a
+ * temporary file next to it, with its final mode, and only when every
+ * one of them reached the disk they are renamed over the old ones, so
+ * runsv never reads a half written 'run'. Each directory is synced once.
+ */
+
+struct SaveBatchFile
+{
+	std::string path;
+	std::string temp;
+	int fd;
+};
+
+struct SaveBatch
+{
+	std::vector<SaveBatchFile> files;
+	bool failed;                 /* the commit only cleans up */
+	size_t replaced;             /* renamed into place by the last commit */
+};
+
+void SaveBatchInit(SaveBatch& batch);
+
+/* 'executable' gives 0755, otherwise the mode of the old file is kept. */
+bool SaveBatchAdd(SaveBatch& batch, std::string const& path,
+		char const* const data, size_t const length, bool const executable);
+
+/*
+ * A failed rename stops the commit, the files not yet renamed are
+ * dropped and the ones already replaced are reported and counted.
+ */
+bool SaveBatchCommit(SaveBatch& batch);
+
+void SaveBatchAbort(SaveBatch& batch);
+
+#endif
@@ -0,0 +1,337 @@
+/*
+	Copyright 2026 Daniel T. Borelli <danieltborelli@gmail.com>
+
+	This file is part of xrunit.
+
+	xrunit is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	xrunit is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with xrunit.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "config.h"
+#include "system.h"
+#include "logfile.h"
+#include "logsearch.h"
+#include "logview.h"
+#include "searchpanel.h"
+
+/* Text of the line shown in the results. */
+#define SEARCH_PANEL_TEXT_MAX 300
+
+struct SearchPanel
+{
+	Fl_Input* text;
+	Fl_Check_Button* regex;
+	Fl_Check_Button* all;
+	Fl_Input* from;
+	Fl_Input* to;
+	Fl_Box* info;
+	Fl_Hold_Browser* results;
+	std::string service;
+	std::vector<std::string> names;
+	std::vector<LogSet> sets;
+	std::vector<LogMatch> matches;
+};
+
+/* ListDirectories has no user data. */
+static std::vector<std::string>* searchPanelNames = NULL;
+
+
+static void SearchPanelNameCb(char const* path)
+{
+	searchPanelNames->push_back(path);
+}
+
+
+static void SearchPanelClose(SearchPanel* panel)
+{
+	for (LogSet& set : panel->sets)
+	{
+		LogSetClose(set);
+	}
+
+	panel->sets.clear();
+	panel->names.clear();
+	panel->matches.clear();
+	panel->results->clear();
+}
+
+
+/* Local time: YYYY-MM-DD [HH:MM[:SS]], empty is no limit. */
+static bool SearchPanelTime(Fl_Input const* input, time_t* const t)
+{
+	char const* const str = input->value();
+
+	*t = 0;
+
+	if (str == NULL || str[0] == '\0')
+	{
+		return true;
+	}
+
+	static char const* const formats[] = {
+		"%Y-%m-%d %H:%M:%S",
+		"%Y-%m-%d %H:%M",
+		"%Y-%m-%d",
+	};
+
+	for (char const* const format : formats)
+	{
+		struct tm tm;
+
+		memset(&tm, 0, sizeof(tm));
+
+		char const* const end = strptime(str, format, &tm);
+
+		if (end != NULL && *end == '\0')
+		{
+			tm.tm_isdst = -1;
+			*t = mktime(&tm);
+			return *t != (time_t)-1;
+		}
+	}
+
+	return false;
+}
+
+
+static void SearchPanelOpen(SearchPanel* panel)
+{
+	SearchPanelClose(panel);
+
+	if (panel->all->value())
+	{
+		searchPanelNames = &panel->names;
+		ListDirectories(SYS_LOG_DIR, SearchPanelNameCb);
+		searchPanelNames = NULL;
+
+		std::sort(panel->names.begin(), panel->names.end());
+	}
+	else
+	{
+		panel->names.push_back(panel->service);
+	}
+
+	panel->sets.resize(panel->names.size());
+
+	for (size_t i = 0; i < panel->names.size(); ++i)
+	{
+		std::string const dir = std::string(SYS_LOG_DIR) + "/" + panel->names[i];
+
+		panel->sets[i].size = 0;
+
+		if (!LogSetOpen(dir.c_str(), panel->sets[i]))
+		{
+			WARNING("Failed to open the log directory '%s': %s", dir.c_str(), strerror(errno));
+		}
+	}
+}
+
+
+static void SearchPanelAddResult(SearchPanel* panel, LogMatch const& match)
+{
+	LogSet const& set = panel->sets[match.set];
+
+	size_t len = 0;
+
+	char const* const line = LogSetLine(set, match.off, &len);
+
+	std::string str = panel->names[match.set];
+
+	str += "\t";
+
+	struct timespec ts;
+
+	if (LogLineTime(line, len, &ts))
+	{
+		char date[32];
+		struct tm tm;
+
+		strftime(date, sizeof(date), "%Y-%m-%d %H:%M:%S", localtime_r(&ts.tv_sec, &tm));
+		str += date;
+	}
+
+	std::string text(line, std::min(len, (size_t)SEARCH_PANEL_TEXT_MAX));
+
+	std::replace(text.begin(), text.end(), '\t', ' ');
+
+	str += "\t";
+	str += text;
+
+	panel->results->add(str.c_str());
+}
+
+
+static void SearchPanelSearchCb(UNUSED Fl_Widget* w, void* data)
+{
+	SearchPanel* panel = (SearchPanel*)data;
+
+	LogSearchQuery query;
+
+	query.text = panel->text->value();
+	query.regex = panel->regex->value() != 0;
+
+	if (query.text.empty())
+	{
+		return;
+	}
+
+	if (!SearchPanelTime(panel->from, &query.from) || !SearchPanelTime(panel->to, &query.to))
+	{
+		fl_alert("Invalid time.\nFormat: YYYY-MM-DD [HH:MM[:SS]]");
+		return;
+	}
+
+	fl_cursor(FL_CURSOR_WAIT);
+	Fl::check();
+
+	SearchPanelOpen(panel);
+
+	struct timespec start, end;
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+
+	LogSearchResult result;
+	std::string error;
+
+	bool const ok = LogSearch(panel->sets, query, result, error);
+
+	clock_gettime(CLOCK_MONOTONIC, &end);
+
+	fl_cursor(FL_CURSOR_DEFAULT);
+
+	if (!ok)
+	{
+		fl_alert("Invalid regular expression: %s\n%s", query.text.c_str(), error.c_str());
+		return;
+	}
+
+	panel->matches.swap(result.matches);
+
+	for (LogMatch const& match : panel->matches)
+	{
+		SearchPanelAddResult(panel, match);
+	}
+
+	double const ms = (end.tv_sec - start.tv_sec) * 1e3 + (end.tv_nsec - start.tv_nsec) / 1e6;
+
+	char str[128];
+
+	snprintf(str, sizeof(str), "%zu%s matches, %.1f MB read in %.0f ms",
+		panel->matches.size(), result.truncated ? "+" : "", result.scanned / (1024.0 * 1024.0), ms);
+
+	panel->info->copy_label(str);
+}
+
+
+/* Double click: the line in the log viewer. */
+static void SearchPanelResultCb(Fl_Widget* w, void* data)
+{
+	SearchPanel* panel = (SearchPanel*)data;
+	Fl_Hold_Browser* results = (Fl_Hold_Browser*)w;
+
+	int const item = results->value();
+
+	if (item < 1 || !Fl::event_clicks())
+	{
+		return;
+	}
+
+	LogMatch const& match = panel->matches[item - 1];
+
+	LogViewShow(panel->sets[match.set].dir.c_str(), panel->names[match.set].c_str(), match.off);
+}
+
+
+static void SearchPanelCloseCb(Fl_Widget* w, void* data)
+{
+	SearchPanel* panel = (SearchPanel*)data;
+
+	SearchPanelClose(panel);
+	delete panel;
+
+	w->hide();
+	Fl::delete_widget(w);
+}
+
+
+static void SearchPanelFont(Fl_Widget* w)
+{
+	w->labelfont(FONT);
+	w->labelsize(FONT_SZ);
+}
+
+
+void SearchPanelShow(char const* const service)
+{
+	ASSERT_DBG_STRING(service);
+
+	SearchPanel* panel = new SearchPanel;
+
+	panel->service = service;
+
+	Fl_Double_Window* wnd = new Fl_Double_Window(760, 480);
+
+	panel->text = new Fl_Input(60, BTN_Y, 360, BTN_H, "Search:");
+	panel->regex = new Fl_Check_Button(430, BTN_Y, BTN_W, BTN_H, "Regex");
+	panel->all = new Fl_Check_Button(430 + BTN_W, BTN_Y, BTN_W + 20, BTN_H, "All services");
+
+	Fl_Button* search = new Fl_Button(wnd->w() - BTN_W - BTN_X, BTN_Y, BTN_W, BTN_H, "Search");
+
+	panel->from = new Fl_Input(60, BTN_Y + BTN_H + 8, 150, BTN_H, "From:");
+	panel->to = new Fl_Input(250, BTN_Y + BTN_H + 8, 150, BTN_H, "To:");
+	panel->info = new Fl_Box(410, BTN_Y + BTN_H + 8, wnd->w() - 420, BTN_H);
+	panel->info->align(Fl_Align(FL_ALIGN_LEFT | FL_ALIGN_INSIDE));
+
+	panel->from->tooltip("YYYY-MM-DD [HH:MM[:SS]]");
+	panel->to->tooltip("YYYY-MM-DD [HH:MM[:SS]]");
+
+	int const y = BTN_Y + (BTN_H + 8) * 2;
+
+	panel->results = new Fl_Hold_Browser(4, y, wnd->w() - 8, wnd->h() - y - 4);
+
+	static int const columnWidths[] = {
+		120, 140, 0
+	};
+
+	panel->results->column_widths(columnWidths);
+	panel->results->column_char('\t');
+	/* svlogd lines start with '@' */
+	panel->results->format_char(0);
+	panel->results->textfont(FL_COURIER);
+	panel->results->textsize(FONT_SZ);
+	panel->results->callback(SearchPanelResultCb, (void*)panel);
+
+	Fl_Widget* const widgets[] = {
+		panel->text, panel->regex, panel->all, search, panel->from, panel->to, panel->info,
+	};
+
+	for (Fl_Widget* const widget : widgets)
+	{
+		SearchPanelFont(widget);
+	}
+
+	panel->text->textfont(FONT);
+	panel->text->textsize(FONT_SZ);
+	panel->text->when(FL_WHEN_ENTER_KEY | FL_WHEN_NOT_CHANGED);
+	panel->text->callback(SearchPanelSearchCb, (void*)panel);
+	search->callback(SearchPanelSearchCb, (void*)panel);
+
+	wnd->resizable(panel->results);
+	wnd->end();
+
+	std::string title = TITLE " - Search log: ";
+	title += service;
+
+	wnd->copy_label(title.c_str());
+	wnd->callback(SearchPanelCloseCb, (void*)panel);
+	wnd->show();
+}
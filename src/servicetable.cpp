@@ -0,0 +1,985 @@
+/*
+	Copyright 2026 Daniel T. Borelli <danieltborelli@gmail.com>
+
+	This file is part of xrunit.
+
+	xrunit is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	xrunit is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with xrunit.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "config.h"
+#include "status.h"
+#include "servicetable.h"
+
+#define SERVICE_TABLE_ROW_H 20
+
+#define SERVICE_TABLE_HEADER_H 20
+
+#define SERVICE_TABLE_PAD 4
+
+/* The detail column takes the rest of the width, at least this. */
+#define SERVICE_TABLE_DETAIL_MIN 100
+
+static char const* const columnLabel[COL_MAX] = {
+	"Service", "State", "Uptime", "PID",
+	"CPU %", "RSS", "Threads", "Files", "Read/s", "Write/s",
+	"Procs", "Tree CPU %", "Tree RSS",
+	"Root", "Status"
+};
+
+static int const columnWidth[COL_MAX] = {
+	160, 60, 70, 60,
+	55, 65, 55, 50, 65, 65,
+	50, 75, 70,
+	120, SERVICE_TABLE_DETAIL_MIN
+};
+
+
+ServiceTable::ServiceTable(int const x, int const y, int const w, int const h)
+	: Fl_Table(x, y, w, h), cursor(-1), anchor(-1), sortCol(COL_NAME),
+	sortDescending(false), iconCb(NULL), contextMenu(NULL), tipRow(-1)
+{
+	memset(selectedState, 0, sizeof(selectedState));
+
+	box(FL_DOWN_FRAME);
+	color(FL_BACKGROUND2_COLOR);
+	rows(0);
+	col_header(1);
+	col_header_height(SERVICE_TABLE_HEADER_H);
+	col_resize(1);
+	row_height_all(SERVICE_TABLE_ROW_H);
+
+	for (int c = 0; c < COL_MAX; ++c)
+	{
+		width[c] = columnWidth[c];
+
+		if ((c < COL_RESOURCE_FIRST || c > COL_RESOURCE_LAST) && c != COL_ROOT)
+		{
+			shown.push_back(c);
+		}
+	}
+
+	end();
+
+	SetColumns();
+
+	FitLastColumn();
+}
+
+
+static int ServiceRowCompare(ServiceRow const& a, ServiceRow const& b, int const col)
+{
+	switch (col)
+	{
+		case COL_NAME:
+			return strcoll(a.key.c_str(), b.key.c_str());
+		case COL_STATE:
+			return a.state - b.state;
+		case COL_UPTIME:
+			return (a.uptime > b.uptime) - (a.uptime < b.uptime);
+		case COL_PID:
+			return (a.pid > b.pid) - (a.pid < b.pid);
+		case COL_CPU:
+			return (a.cpu > b.cpu) - (a.cpu < b.cpu);
+		case COL_RSS:
+			return (a.rss > b.rss) - (a.rss < b.rss);
+		case COL_THREADS:
+			return a.threads - b.threads;
+		case COL_FDS:
+			return a.fds - b.fds;
+		case COL_READ:
+			return (a.readRate > b.readRate) - (a.readRate < b.readRate);
+		case COL_WRITE:
+			return (a.writeRate > b.writeRate) - (a.writeRate < b.writeRate);
+		case COL_PROCS:
+			return a.procs - b.procs;
+		case COL_TREE_CPU:
+			return (a.treeCpu > b.treeCpu) - (a.treeCpu < b.treeCpu);
+		case COL_TREE_RSS:
+			return (a.treeRss > b.treeRss) - (a.treeRss < b.treeRss);
+		case COL_ROOT:
+			return a.group - b.group;
+		case COL_DETAIL:
+			return strcoll(a.detail.c_str(), b.detail.c_str());
+		default:
+			STOP_DBG("Column not contemplated: %d", col);
+	}
+
+	return 0;
+}
+
+
+/* Sorts and indexes the rows, the cursor stays on its service. */
+void ServiceTable::SortRows(std::string const& current)
+{
+	int const col = sortCol;
+	bool const descending = sortDescending;
+
+	// By group, the best filter matches first, then by the column.
+	auto const less = [col, descending](ServiceRow const& a, ServiceRow const& b) {
+		if (a.group != b.group)
+		{
+			return a.group < b.group;
+		}
+
+		if (a.rank != b.rank)
+		{
+			return a.rank < b.rank;
+		}
+
+		int cmp = ServiceRowCompare(a, b, col);
+
+		if (descending)
+		{
+			cmp = -cmp;
+		}
+
+		if (cmp == 0 && col != COL_NAME)
+		{
+			cmp = strcoll(a.key.c_str(), b.key.c_str());
+		}
+
+		return cmp < 0;
+	};
+
+	// The snapshot already comes by name.
+	if (!std::is_sorted(entries.begin(), entries.end(), less))
+	{
+		std::sort(entries.begin(), entries.end(), less);
+	}
+
+	index.clear();
+	index.reserve(entries.size());
+
+	for (size_t i = 0; i < entries.size(); ++i)
+	{
+		index[entries[i].key] = i;
+	}
+
+	auto const it = index.find(current);
+
+	if (it != index.end())
+	{
+		cursor = (int)it->second;
+	}
+	else if (cursor >= (int)entries.size())
+	{
+		cursor = (int)entries.size() - 1;
+	}
+	else if (cursor < 0 && entries.size() > 0)
+	{
+		cursor = 0;
+	}
+
+	anchor = cursor;
+}
+
+
+size_t ServiceTable::Update(std::vector<ServiceRow>& next)
+{
+	size_t changed = 0;
+	size_t kept = 0;
+
+	for (ServiceRow& row : next)
+	{
+		row.selected = false;
+
+		auto const it = index.find(row.key);
+
+		if (it == index.end())
+		{
+			++changed;
+			continue;
+		}
+
+		ServiceRow const& prev = entries[it->second];
+
+		++kept;
+
+		if (prev.state != row.state || prev.pid != row.pid ||
+			prev.uptime != row.uptime || prev.detail != row.detail ||
+			prev.warning != row.warning || prev.sampled != row.sampled ||
+			prev.cpu != row.cpu || prev.rss != row.rss ||
+			prev.threads != row.threads || prev.fds != row.fds ||
+			prev.readRate != row.readRate || prev.writeRate != row.writeRate ||
+			prev.tree != row.tree || prev.procs != row.procs ||
+			prev.treeCpu != row.treeCpu || prev.treeRss != row.treeRss ||
+			prev.group != row.group)
+		{
+			++changed;
+		}
+	}
+
+	changed += entries.size() - kept;
+
+	std::string const current = (Current() != NULL) ? Current() : "";
+
+	entries.swap(next);
+
+	SortRows(current);
+
+	memset(selectedState, 0, sizeof(selectedState));
+
+	for (auto it = selection.begin(); it != selection.end(); )
+	{
+		auto const row = index.find(*it);
+
+		if (row == index.end())
+		{
+			it = selection.erase(it);
+			continue;
+		}
+
+		entries[row->second].selected = true;
+		++selectedState[entries[row->second].state];
+		++it;
+	}
+
+	if (entries.size() != (size_t)rows())
+	{
+		rows((int)entries.size());
+	}
+
+	if (changed > 0)
+	{
+		redraw();
+	}
+
+	return changed;
+}
+
+
+void ServiceTable::Sort(int const col, bool const descending)
+{
+	ASSERT_DBG(col >= 0 && col < COL_MAX);
+
+	std::string const current = (Current() != NULL) ? Current() : "";
+
+	sortCol = col;
+	sortDescending = descending;
+
+	// The selected flag moves with its row.
+	SortRows(current);
+
+	ShowRow(cursor);
+	redraw();
+}
+
+
+char const* ServiceTable::Current(void) const
+{
+	if (cursor < 0 || cursor >= (int)entries.size())
+	{
+		return NULL;
+	}
+
+	return entries[cursor].key.c_str();
+}
+
+
+size_t ServiceTable::SelectedCount(int const state) const
+{
+	ASSERT_DBG(state >= 0 && state < STATE_MAX);
+
+	if (selection.empty())
+	{
+		return (Current() != NULL && entries[cursor].state == state) ? 1 : 0;
+	}
+
+	return selectedState[state];
+}
+
+
+/* In the order of the table, the cursor when nothing is selected. */
+void ServiceTable::Selected(std::vector<std::string>& keys) const
+{
+	keys.clear();
+
+	if (selection.empty())
+	{
+		if (Current() != NULL)
+		{
+			keys.push_back(Current());
+		}
+
+		return;
+	}
+
+	std::vector<size_t> ids;
+	ids.reserve(selection.size());
+
+	for (std::string const& key : selection)
+	{
+		ids.push_back(index.at(key));
+	}
+
+	std::sort(ids.begin(), ids.end());
+
+	for (size_t const id : ids)
+	{
+		keys.push_back(entries[id].key);
+	}
+}
+
+
+void ServiceTable::SetSelected(int const row, bool const selected)
+{
+	ASSERT_DBG(row >= 0 && row < (int)entries.size());
+
+	ServiceRow& r = entries[row];
+
+	if (r.selected == selected)
+	{
+		return;
+	}
+
+	r.selected = selected;
+
+	if (selected)
+	{
+		selection.insert(r.key);
+		++selectedState[r.state];
+	}
+	else
+	{
+		selection.erase(r.key);
+		--selectedState[r.state];
+	}
+
+	redraw_range(row, row, 0, cols() - 1);
+}
+
+
+void ServiceTable::ClearSelection(void)
+{
+	for (std::string const& key : selection)
+	{
+		int const row = (int)index.at(key);
+
+		entries[row].selected = false;
+		redraw_range(row, row, 0, cols() - 1);
+	}
+
+	selection.clear();
+	memset(selectedState, 0, sizeof(selectedState));
+}
+
+
+void ServiceTable::SelectRange(int const from, int const to)
+{
+	ClearSelection();
+
+	for (int row = std::min(from, to); row <= std::max(from, to); ++row)
+	{
+		SetSelected(row, true);
+	}
+}
+
+
+void ServiceTable::Select(int const row)
+{
+	if (entries.empty())
+	{
+		return;
+	}
+
+	MoveCursor(row, false);
+}
+
+
+void ServiceTable::MoveCursor(int const row, bool const extend)
+{
+	if (entries.empty())
+	{
+		return;
+	}
+
+	int const last = cursor;
+
+	cursor = std::max(0, std::min(row, (int)entries.size() - 1));
+
+	if (last >= 0 && last < (int)entries.size())
+	{
+		redraw_range(last, last, 0, cols() - 1);
+	}
+
+	if (extend && anchor >= 0)
+	{
+		SelectRange(anchor, cursor);
+	}
+	else
+	{
+		anchor = cursor;
+		ClearSelection();
+		SetSelected(cursor, true);
+	}
+
+	ShowRow(cursor);
+	do_callback();
+}
+
+
+void ServiceTable::ShowRow(int const row)
+{
+	if (row < 0)
+	{
+		return;
+	}
+
+	int r1 = 0, r2 = 0, c1 = 0, c2 = 0;
+
+	visible_cells(r1, r2, c1, c2);
+
+	// The last visible row may be cut.
+	if (row < r1)
+	{
+		row_position(row);
+	}
+	else if (row >= r2 && r2 > r1)
+	{
+		row_position(row - (r2 - r1) + 1);
+	}
+}
+
+
+void ServiceTable::FitLastColumn(void)
+{
+	int used = 0;
+
+	int const last = cols() - 1;
+
+	ASSERT_DBG(shown[last] == COL_DETAIL);
+
+	for (int c = 0; c < last; ++c)
+	{
+		used += col_width(c);
+	}
+
+	col_width(last, std::max(tiw - used, SERVICE_TABLE_DETAIL_MIN));
+}
+
+
+void ServiceTable::resize(int x, int y, int w, int h)
+{
+	Fl_Table::resize(x, y, w, h);
+	FitLastColumn();
+}
+
+
+bool ServiceTable::ColumnShown(int const col) const
+{
+	return std::find(shown.begin(), shown.end(), col) != shown.end();
+}
+
+
+bool ServiceTable::ResourcesShown(void) const
+{
+	for (int const col : shown)
+	{
+		if (col >= COL_RESOURCE_FIRST && col <= COL_RESOURCE_LAST)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+
+bool ServiceTable::TreeShown(void) const
+{
+	return ColumnShown(COL_PROCS) || ColumnShown(COL_TREE_CPU) || ColumnShown(COL_TREE_RSS);
+}
+
+
+/* The table columns from 'shown', keeping the widths set by hand. */
+void ServiceTable::SetColumns(void)
+{
+	for (int c = 0; c < cols() && c < (int)shown.size(); ++c)
+	{
+		width[shown[c]] = col_width(c);
+	}
+
+	cols((int)shown.size());
+
+	for (int c = 0; c < cols(); ++c)
+	{
+		col_width(c, width[shown[c]]);
+	}
+
+	FitLastColumn();
+}
+
+
+void ServiceTable::Groups(std::vector<std::string> const& labels)
+{
+	groups = labels;
+
+	ShowColumn(COL_ROOT, groups.size() > 1);
+}
+
+
+void ServiceTable::ShowColumn(int const col, bool const show)
+{
+	ASSERT_DBG(col >= 0 && col < COL_MAX);
+
+	// The name and the status are always shown.
+	if (col == COL_NAME || col == COL_DETAIL || ColumnShown(col) == show)
+	{
+		return;
+	}
+
+	// Widths of the current columns, before they move.
+	for (int c = 0; c < cols(); ++c)
+	{
+		width[shown[c]] = col_width(c);
+	}
+
+	if (show)
+	{
+		shown.push_back(col);
+		std::sort(shown.begin(), shown.end());
+	}
+	else
+	{
+		shown.erase(std::find(shown.begin(), shown.end(), col));
+	}
+
+	cols(0);
+	SetColumns();
+
+	if (!show && col == sortCol)
+	{
+		Sort(COL_NAME, false);
+	}
+
+	redraw();
+	do_callback();
+}
+
+
+void ServiceTable::ColumnsMenu(void)
+{
+	Fl_Menu_Item items[COL_MAX + 1];
+
+	memset(items, 0, sizeof(items));
+
+	int n = 0;
+
+	for (int col = COL_STATE; col < COL_DETAIL; ++col)
+	{
+		items[n].text = columnLabel[col];
+		items[n].flags = FL_MENU_TOGGLE | (ColumnShown(col) ? FL_MENU_VALUE : 0);
+		items[n].user_data_ = (void*)(intptr_t)col;
+		++n;
+	}
+
+	Fl_Menu_Item const* const item = items->popup(Fl::event_x(), Fl::event_y());
+
+	if (item != NULL)
+	{
+		int const col = (int)(intptr_t)item->user_data();
+
+		ShowColumn(col, !ColumnShown(col));
+	}
+}
+
+
+/* The history of an unstable service, over its name. */
+void ServiceTable::ShowTooltip(void)
+{
+	int R = -1, C = -1;
+	ResizeFlag resize = RESIZE_NONE;
+
+	TableContext const context = cursor2rowcol(R, C, resize);
+
+	if (context != CONTEXT_CELL || shown[C] != COL_NAME || entries[R].warning.empty())
+	{
+		if (tipRow != -1)
+		{
+			tipRow = -1;
+			Fl_Tooltip::enter_area(this, 0, 0, 0, 0, NULL);
+		}
+
+		return;
+	}
+
+	if (R == tipRow && tip == entries[R].warning)
+	{
+		return;
+	}
+
+	int X = 0, Y = 0, W = 0, H = 0;
+
+	find_cell(CONTEXT_CELL, R, C, X, Y, W, H);
+
+	tipRow = R;
+	tip = entries[R].warning;
+
+	Fl_Tooltip::enter_area(this, X, Y, W, H, tip.c_str());
+}
+
+
+int ServiceTable::handle(int event)
+{
+	switch (event)
+	{
+		case FL_MOVE:
+			ShowTooltip();
+			break;
+
+		case FL_FOCUS:
+		case FL_UNFOCUS:
+			redraw();
+			return 1;
+
+		case FL_PUSH:
+		case FL_DRAG:
+		{
+			int R = -1, C = -1;
+			ResizeFlag resize = RESIZE_NONE;
+
+			TableContext const context = cursor2rowcol(R, C, resize);
+
+			if (event == FL_PUSH && context == CONTEXT_COL_HEADER && Fl::event_button() == FL_RIGHT_MOUSE)
+			{
+				ColumnsMenu();
+				return 1;
+			}
+
+			// On the row under the mouse, keeping the selection if it is inside.
+			if (event == FL_PUSH && context == CONTEXT_CELL && Fl::event_button() == FL_RIGHT_MOUSE &&
+				contextMenu != NULL)
+			{
+				if (!entries[R].selected)
+				{
+					MoveCursor(R, false);
+				}
+
+				Fl_Menu_Item const* const item = contextMenu->popup(Fl::event_x(), Fl::event_y());
+
+				if (item != NULL)
+				{
+					item->do_callback(this);
+				}
+
+				return 1;
+			}
+
+			if (Fl::event_button() != FL_LEFT_MOUSE || is_interactive_resize() || resize != RESIZE_NONE)
+			{
+				break;
+			}
+
+			if (event == FL_PUSH && context == CONTEXT_COL_HEADER)
+			{
+				Sort(shown[C], shown[C] == sortCol && !sortDescending);
+				return 1;
+			}
+
+			if (context != CONTEXT_CELL)
+			{
+				break;
+			}
+
+			if (event == FL_DRAG)
+			{
+				if (R != cursor)
+				{
+					MoveCursor(R, true);
+				}
+
+				return 1;
+			}
+
+			if (Fl::focus() != this)
+			{
+				Fl::focus(this);
+				redraw();
+			}
+
+			if (Fl::event_state(FL_CTRL))
+			{
+				if (cursor >= 0)
+				{
+					redraw_range(cursor, cursor, 0, cols() - 1);
+				}
+
+				cursor = anchor = R;
+				SetSelected(R, !entries[R].selected);
+				do_callback();
+				return 1;
+			}
+
+			MoveCursor(R, Fl::event_state(FL_SHIFT) != 0);
+			return 1;
+		}
+
+		case FL_KEYBOARD:
+		{
+			int r1 = 0, r2 = 0, c1 = 0, c2 = 0;
+
+			visible_cells(r1, r2, c1, c2);
+
+			int const page = std::max(1, r2 - r1);
+			bool const extend = (Fl::event_state(FL_SHIFT) != 0);
+
+			switch (Fl::event_key())
+			{
+				case FL_Up:
+					MoveCursor(cursor - 1, extend);
+					return 1;
+				case FL_Down:
+					MoveCursor(cursor + 1, extend);
+					return 1;
+				case FL_Page_Up:
+					MoveCursor(cursor - page, extend);
+					return 1;
+				case FL_Page_Down:
+					MoveCursor(cursor + page, extend);
+					return 1;
+				case FL_Home:
+					MoveCursor(0, extend);
+					return 1;
+				case FL_End:
+					MoveCursor((int)entries.size() - 1, extend);
+					return 1;
+				case 'a':
+					if (Fl::event_state(FL_CTRL) && !entries.empty())
+					{
+						SelectRange(0, (int)entries.size() - 1);
+						do_callback();
+						return 1;
+					}
+					break;
+			}
+
+			break;
+		}
+	}
+
+	return Fl_Table::handle(event);
+}
+
+
+/* 1536 -> "1.5K" */
+static void FormatBytes(double bytes, char const* const suffix, char* buffer)
+{
+	static char const units[] = "BKMGT";
+
+	int unit = 0;
+
+	while (bytes >= 1024.0 && units[unit + 1] != '\0')
+	{
+		bytes /= 1024.0;
+		++unit;
+	}
+
+	if (unit == 0)
+	{
+		snprintf(buffer, STR_SZ, "%.0f%s", bytes, suffix);
+	}
+	else
+	{
+		snprintf(buffer, STR_SZ, "%.1f%c%s", bytes, units[unit], suffix);
+	}
+}
+
+
+void ServiceTable::draw_cell(TableContext context, int R, int C, int X, int Y, int W, int H)
+{
+	switch (context)
+	{
+		case CONTEXT_STARTPAGE:
+			fl_font(FONT, FONT_SZ);
+			return;
+
+		case CONTEXT_COL_HEADER:
+		{
+			fl_push_clip(X, Y, W, H);
+			fl_draw_box(FL_THIN_UP_BOX, X, Y, W, H, FL_BACKGROUND_COLOR);
+			fl_color(FL_FOREGROUND_COLOR);
+			fl_draw(columnLabel[shown[C]], X + SERVICE_TABLE_PAD, Y, W - SERVICE_TABLE_PAD * 2, H, FL_ALIGN_LEFT);
+
+			if (shown[C] == sortCol)
+			{
+				int const cx = X + W - SERVICE_TABLE_PAD * 3;
+				int const cy = Y + H / 2;
+
+				fl_color(FL_DARK3);
+
+				if (sortDescending)
+				{
+					fl_polygon(cx - 3, cy - 2, cx + 3, cy - 2, cx, cy + 2);
+				}
+				else
+				{
+					fl_polygon(cx - 3, cy + 2, cx + 3, cy + 2, cx, cy - 2);
+				}
+			}
+
+			fl_pop_clip();
+			return;
+		}
+
+		case CONTEXT_CELL:
+		{
+			if (R < 0 || R >= (int)entries.size())
+			{
+				return;
+			}
+
+			ServiceRow const& row = entries[R];
+
+			Fl_Color bg = FL_BACKGROUND2_COLOR;
+			Fl_Color fg = FL_FOREGROUND_COLOR;
+
+			if (row.selected)
+			{
+				bg = selection_color();
+				fg = fl_contrast(fg, bg);
+			}
+
+			fl_push_clip(X, Y, W, H);
+			fl_color(bg);
+			fl_rectf(X, Y, W, H);
+
+			char buffer[STR_SZ] = { '\0' };
+			char const* text = buffer;
+			int tx = X + SERVICE_TABLE_PAD;
+
+			int const col = shown[C];
+
+			switch (col)
+			{
+				case COL_NAME:
+					if (iconCb != NULL)
+					{
+						Fl_Image* icon = iconCb(row.state, !row.warning.empty());
+
+						if (icon != NULL)
+						{
+							icon->draw(tx, Y + (H - icon->h()) / 2);
+							tx += icon->w() + SERVICE_TABLE_PAD;
+						}
+					}
+					// The other run directories are named by path.
+					text = (row.group > 0) ? strrchr(row.key.c_str(), '/') + 1 : row.key.c_str();
+					break;
+				case COL_ROOT:
+					if (row.group >= 0 && row.group < (int)groups.size())
+					{
+						text = groups[row.group].c_str();
+					}
+					break;
+				case COL_STATE:
+					text = StatusStateName(row.state);
+					break;
+				case COL_UPTIME:
+					if (row.state != STATE_FAIL)
+					{
+						snprintf(buffer, STR_SZ, "%lds", row.uptime);
+					}
+					break;
+				case COL_PID:
+					if (row.pid != 0)
+					{
+						snprintf(buffer, STR_SZ, "%d", (int)row.pid);
+					}
+					break;
+				case COL_CPU:
+					if (row.sampled)
+					{
+						snprintf(buffer, STR_SZ, "%.1f", row.cpu);
+					}
+					break;
+				case COL_RSS:
+					if (row.sampled)
+					{
+						FormatBytes((double)row.rss, "", buffer);
+					}
+					break;
+				case COL_THREADS:
+					if (row.sampled)
+					{
+						snprintf(buffer, STR_SZ, "%d", row.threads);
+					}
+					break;
+				case COL_FDS:
+					if (row.sampled)
+					{
+						snprintf(buffer, STR_SZ, "%d", row.fds);
+					}
+					break;
+				case COL_READ:
+					if (row.sampled)
+					{
+						FormatBytes(row.readRate, "/s", buffer);
+					}
+					break;
+				case COL_WRITE:
+					if (row.sampled)
+					{
+						FormatBytes(row.writeRate, "/s", buffer);
+					}
+					break;
+				case COL_PROCS:
+					if (row.tree)
+					{
+						snprintf(buffer, STR_SZ, "%d", row.procs);
+					}
+					break;
+				case COL_TREE_CPU:
+					if (row.tree)
+					{
+						snprintf(buffer, STR_SZ, "%.1f", row.treeCpu);
+					}
+					break;
+				case COL_TREE_RSS:
+					if (row.tree)
+					{
+						FormatBytes((double)row.treeRss, "", buffer);
+					}
+					break;
+				case COL_DETAIL:
+					text = row.detail.c_str();
+					break;
+				default:
+					STOP_DBG("Column not contemplated: %d", col);
+			}
+
+			fl_color(fg);
+			fl_draw(text, tx, Y, X + W - tx - SERVICE_TABLE_PAD, H, FL_ALIGN_LEFT);
+
+			// First row of a group.
+			if (R > 0 && entries[R - 1].group != row.group)
+			{
+				fl_color(FL_DARK3);
+				fl_xyline(X, Y, X + W - 1);
+			}
+
+			if (R == cursor && Fl::focus() == this)
+			{
+				fl_line_style(FL_DOT);
+				fl_xyline(X, Y, X + W - 1);
+				fl_xyline(X, Y + H - 1, X + W - 1);
+				fl_line_style(0);
+			}
+
+			fl_pop_clip();
+			return;
+		}
+
+		default:
+			return;
+	}
+}
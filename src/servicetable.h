@@ -0,0 +1,157 @@
+/*
+	Copyright 2026 Daniel T. Borelli <danieltborelli@gmail.com>
+
+	This file is part of xrunit.
+
+	xrunit is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	xrunit is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with xrunit.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef SERVICETABLE_H_INCLUDE
+#define SERVICETABLE_H_INCLUDE
+
+/*
+ * Table of the supervised services drawn straight from its rows:
+ * only the visible cells are drawn and the selection is a set of
+ * names, with the selected count of each state kept up to date.
+ * The resource columns are hidden until chosen in the menu of the
+ * column titles (right click). With several run directories the rows
+ * are kept together by group.
+ */
+
+enum {
+	COL_NAME = 0,
+	COL_STATE,
+	COL_UPTIME,
+	COL_PID,
+	COL_CPU,
+	COL_RSS,
+	COL_THREADS,
+	COL_FDS,
+	COL_READ,
+	COL_WRITE,
+	COL_PROCS,
+	COL_TREE_CPU,
+	COL_TREE_RSS,
+	COL_ROOT,
+	COL_DETAIL,
+	COL_MAX,
+};
+
+/* Columns of the /proc sampling. */
+#define COL_RESOURCE_FIRST COL_CPU
+#define COL_RESOURCE_LAST COL_TREE_RSS
+
+struct ServiceRow
+{
+	std::string key;
+	std::string detail;  /* StatusFormatDetail */
+	std::string warning; /* tooltip of an unstable service, or empty */
+	long uptime;
+	int rank;            /* of the filter match, 0 without a filter */
+	int group;           /* index in Groups() */
+	pid_t pid;
+	int state;
+	bool selected;
+	bool sampled;        /* the resource fields are known */
+	double cpu;
+	double readRate;
+	double writeRate;
+	unsigned long long rss;
+	int threads;
+	int fds;
+	bool tree;           /* the process tree fields are known */
+	int procs;           /* of the whole tree of the service */
+	double treeCpu;
+	unsigned long long treeRss;
+};
+
+typedef Fl_Image* (*ServiceIconCb)(int const state, bool const warning);
+
+class ServiceTable : public Fl_Table
+{
+public:
+	ServiceTable(int const x, int const y, int const w, int const h);
+
+	/* Takes the rows, returns how many changed. */
+	size_t Update(std::vector<ServiceRow>& next);
+
+	void Sort(int const col, bool const descending);
+
+	/* Only 'row' selected, with the cursor. */
+	void Select(int const row);
+
+	/* Service of the row with the cursor, NULL when there are no entries. */
+	char const* Current(void) const;
+
+	size_t SelectedCount(void) const { return selection.size(); }
+
+	/* Without a selection the row with the cursor counts as selected. */
+	size_t SelectedCount(int const state) const;
+
+	void Selected(std::vector<std::string>& keys) const;
+
+	void StateIcon(ServiceIconCb cb) { iconCb = cb; }
+
+	/* Labels of the groups, with more than one the Root column is shown. */
+	void Groups(std::vector<std::string> const& labels);
+
+	bool ColumnShown(int const col) const;
+
+	void ShowColumn(int const col, bool const show);
+
+	/* Some column needs the /proc sampling. */
+	bool ResourcesShown(void) const;
+
+	bool TreeShown(void) const;
+
+	/* Shown with a right click over a service. */
+	void ContextMenu(Fl_Menu_Item const* menu) { contextMenu = menu; }
+
+	int handle(int event);
+
+	void resize(int x, int y, int w, int h);
+
+protected:
+	void draw_cell(TableContext context, int R, int C, int X, int Y, int W, int H);
+
+private:
+	std::vector<ServiceRow> entries;
+	std::unordered_map<std::string, size_t> index;
+	std::unordered_set<std::string> selection;
+	size_t selectedState[STATE_MAX];
+	int cursor;
+	int anchor;
+	int sortCol;
+	bool sortDescending;
+	ServiceIconCb iconCb;
+	Fl_Menu_Item const* contextMenu;
+	int tipRow;
+	std::string tip;     /* Fl_Tooltip keeps the pointer */
+	std::vector<int> shown; /* COL_* of each table column */
+	std::vector<std::string> groups;
+	int width[COL_MAX];
+
+	void SortRows(std::string const& current);
+	void SetSelected(int const row, bool const selected);
+	void ClearSelection(void);
+	void SelectRange(int const from, int const to);
+	void MoveCursor(int const row, bool const extend);
+	void ShowRow(int const row);
+	void FitLastColumn(void);
+	void ShowTooltip(void);
+	void ColumnsMenu(void);
+	void SetColumns(void);
+};
+
+#endif
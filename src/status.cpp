@@ -0,0 +1,454 @@
+/*
+	Copyright 2026 Daniel T. Borelli <danieltborelli@gmail.com>
+
+	This file is part of xrunit.
+
+	xrunit is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	xrunit is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with xrunit.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "config.h"
+#include "status.h"
+#include "control.h"
+#include "perf.h"
+
+#include <memory>
+#include <thread>
+
+/* TAI64 label of the unix epoch: 2^62 + 10 leap seconds */
+#define TAI64_UNIX_EPOCH 4611686018427387914ULL
+
+static char const* const STATE_NAME[STATE_MAX] = {
+	[STATE_DOWN] = "down",
+	[STATE_RUN] = "run",
+	[STATE_FINISH] = "finish",
+	[STATE_FAIL] = "fail",
+};
+
+
+char const* StatusStateName(int const state)
+{
+	ASSERT_DBG(state >= STATE_DOWN && state < STATE_MAX);
+	return STATE_NAME[state];
+}
+
+
+static void StatusFail(SuperviseStatus* const st, int const error)
+{
+	st->state = STATE_FAIL;
+	st->error = error;
+}
+
+
+/*
+ * Same checks that sv(8) does: 'supervise/ok' tells if runsv
+ * is running, 'supervise/status' is the 20 bytes record:
+ *
+ *  0..7  TAI64 time of the last state change (big endian)
+ *  8..11 nanoseconds
+ * 12..15 pid (little endian)
+ * 16     paused
+ * 17     want 'u' or 'd'
+ * 18     got TERM
+ * 19     0 down, 1 run, 2 finish
+ */
+bool StatusReadSupervise(int const dirfd, char const* const dir, SuperviseStatus* const st)
+{
+	ASSERT_DBG_STRING(dir);
+	ASSERT_DBG(st);
+
+	memset(st, 0, sizeof(SuperviseStatus));
+
+	std::string path = dir;
+	path += "/supervise/ok";
+
+	errno = 0;
+
+	int fd = openat(dirfd, path.c_str(), O_WRONLY | O_NONBLOCK | O_CLOEXEC);
+
+	if (fd == -1)
+	{
+		StatusFail(st, errno);
+		return false;
+	}
+
+	close(fd);
+
+	path = dir;
+	path += "/supervise/status";
+
+	errno = 0;
+
+	fd = openat(dirfd, path.c_str(), O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+
+	if (fd == -1)
+	{
+		StatusFail(st, errno);
+		return false;
+	}
+
+	unsigned char rec[STATUS_RECORD_SZ];
+
+	errno = 0;
+
+	ssize_t const n = read(fd, rec, STATUS_RECORD_SZ);
+
+	close(fd);
+
+	if (n != STATUS_RECORD_SZ)
+	{
+		StatusFail(st, (n == -1) ? errno : EIO);
+		return false;
+	}
+
+	PERF_COUNT(PERF_BYTES_READ, STATUS_RECORD_SZ);
+
+	unsigned long long tai = 0;
+
+	for (int i = 0; i < 8; ++i)
+	{
+		tai = (tai << 8) | rec[i];
+	}
+
+	st->since = (tai > TAI64_UNIX_EPOCH) ? (time_t)(tai - TAI64_UNIX_EPOCH) : 0;
+
+	st->pid = (pid_t)((unsigned)rec[12]
+			| ((unsigned)rec[13] << 8)
+			| ((unsigned)rec[14] << 16)
+			| ((unsigned)rec[15] << 24));
+
+	st->paused = rec[16] != 0;
+	st->wantUp = rec[17] == 'u';
+	st->wantDown = rec[17] == 'd';
+	st->gotTerm = rec[18] != 0;
+
+	switch (rec[19])
+	{
+		case 0:
+			st->state = STATE_DOWN;
+			break;
+		case 1:
+			st->state = STATE_RUN;
+			break;
+		case 2:
+			st->state = STATE_FINISH;
+			break;
+		default:
+			StatusFail(st, EPROTO);
+			return false;
+	}
+
+	path = dir;
+	path += "/down";
+
+	struct stat sb;
+
+	st->normallyUp = (fstatat(dirfd, path.c_str(), &sb, 0) == -1 && errno == ENOENT);
+
+	return true;
+}
+
+
+static void StatusReadServiceAt(int const dirfd, char const* const dir, ServiceStatus* const st)
+{
+	StatusReadSupervise(dirfd, dir, &st->srv);
+
+	std::string log = dir;
+	log += "/log";
+
+	struct stat sb;
+
+	st->hasLog = (fstatat(dirfd, log.c_str(), &sb, 0) == 0 && S_ISDIR(sb.st_mode));
+
+	if (st->hasLog)
+	{
+		/* Like sv(8), the log is only shown when its runsv answers. */
+		st->hasLog = StatusReadSupervise(dirfd, log.c_str(), &st->log);
+	}
+}
+
+
+void StatusReadService(ServiceStatus* const st)
+{
+	ASSERT_DBG(st);
+	ASSERT_DBG_STRING(st->path.c_str());
+
+	StatusReadServiceAt(AT_FDCWD, st->path.c_str(), st);
+}
+
+
+static int StatusScanFilter(struct dirent const* ent)
+{
+	/* Same entries that the shell glob 'SV_RUN_DIR/ *' expands. */
+	return ent->d_name[0] != '.';
+}
+
+
+bool StatusScan(char const* const runDir, StatusSnapshot& snap)
+{
+	ASSERT_DBG_STRING(runDir);
+
+	snap.clear();
+
+	errno = 0;
+
+	int const dirfd = open(runDir, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+
+	if (dirfd == -1)
+	{
+		return false;
+	}
+
+	struct dirent** dirList = NULL;
+
+	int const n = scandirat(dirfd, ".", &dirList, StatusScanFilter, alphasort);
+
+	if (n == -1)
+	{
+		int const error = errno;
+		close(dirfd);
+		errno = error;
+		return false;
+	}
+
+	snap.resize(n);
+
+	for (int i = 0; i < n; ++i)
+	{
+		ServiceStatus& st = snap[i];
+
+		st.name = dirList[i]->d_name;
+		st.path = runDir;
+		st.path += "/";
+		st.path += st.name;
+
+		StatusReadServiceAt(dirfd, st.name.c_str(), &st);
+
+		free(dirList[i]);
+	}
+
+	free(dirList);
+	close(dirfd);
+
+	return true;
+}
+
+
+static void StatusScanRoot(std::vector<std::string> const& roots, size_t const root,
+	StatusSnapshot& snap, bool& ok)
+{
+	ok = StatusScan(roots[root].c_str(), snap);
+
+	if (!ok)
+	{
+		WARNING("Failed to read the services: %s: %s", roots[root].c_str(), strerror(errno));
+		return;
+	}
+
+	for (ServiceStatus& st : snap)
+	{
+		st.root = (int)root;
+
+		if (root > 0)
+		{
+			st.name = st.path;
+		}
+	}
+}
+
+
+bool StatusScanRoots(std::vector<std::string> const& roots, StatusSnapshot& snap)
+{
+	ASSERT_DBG(roots.size() > 0);
+
+	if (roots.size() == 1)
+	{
+		return StatusScan(roots[0].c_str(), snap);
+	}
+
+	std::vector<StatusSnapshot> snaps(roots.size());
+
+	// std::vector<bool> is not one byte per element.
+	std::unique_ptr<bool[]> ok(new bool[roots.size()]);
+
+	std::vector<std::thread> workers;
+
+	// A thread costs about a scan: one extra root is scanned here after the first.
+	for (size_t root = 1; root < roots.size() && roots.size() > 2; ++root)
+	{
+		workers.emplace_back(StatusScanRoot, std::cref(roots), root, std::ref(snaps[root]), std::ref(ok[root]));
+	}
+
+	StatusScanRoot(roots, 0, snaps[0], ok[0]);
+
+	int const error = errno;
+
+	if (roots.size() == 2)
+	{
+		StatusScanRoot(roots, 1, snaps[1], ok[1]);
+	}
+
+	for (std::thread& t : workers)
+	{
+		t.join();
+	}
+
+	if (!ok[0])
+	{
+		errno = error;
+		return false;
+	}
+
+	snap = std::move(snaps[0]);
+
+	for (size_t root = 1; root < roots.size(); ++root)
+	{
+		snap.insert(snap.end(), std::make_move_iterator(snaps[root].begin()),
+			std::make_move_iterator(snaps[root].end()));
+	}
+
+	return true;
+}
+
+
+static void StatusFormatFlags(SuperviseStatus const& st, std::string& line)
+{
+	if (st.pid && !st.normallyUp)
+	{
+		line += ", normally down";
+	}
+
+	if (!st.pid && st.normallyUp)
+	{
+		line += ", normally up";
+	}
+
+	if (st.pid && st.paused)
+	{
+		line += ", paused";
+	}
+
+	if (!st.pid && st.wantUp)
+	{
+		line += ", want up";
+	}
+
+	if (st.pid && st.wantDown)
+	{
+		line += ", want down";
+	}
+
+	if (st.pid && st.gotTerm)
+	{
+		line += ", got TERM";
+	}
+}
+
+
+static void StatusFormatSupervise(SuperviseStatus const& st, char const* const name,
+								char const* const sep, time_t const now, std::string& line)
+{
+	char buffer[STR_SZ];
+
+	line += StatusStateName(st.state);
+	line += sep;
+	line += name;
+	line += ": ";
+
+	if (st.state == STATE_FAIL)
+	{
+		line += ControlError(st.error);
+		return;
+	}
+
+	if (st.state != STATE_DOWN)
+	{
+		snprintf(buffer, STR_SZ, "(pid %d) ", (int)st.pid);
+		line += buffer;
+	}
+
+	long const uptime = (now > st.since) ? (long)(now - st.since) : 0L;
+
+	snprintf(buffer, STR_SZ, "%lds", uptime);
+	line += buffer;
+
+	StatusFormatFlags(st, line);
+}
+
+
+/* Same text that 'sv status' prints, with a tab after the state. */
+void StatusFormat(ServiceStatus const& st, time_t const now, std::string& line)
+{
+	line.clear();
+
+	StatusFormatSupervise(st.srv, st.path.c_str(), "\t", now, line);
+
+	if (st.hasLog)
+	{
+		line += "; ";
+		StatusFormatSupervise(st.log, "log", ": ", now, line);
+	}
+}
+
+
+/*
+ * What 'sv status' prints after the uptime of the service:
+ * its flags and the log service, or the error.
+ */
+void StatusFormatDetail(ServiceStatus const& st, time_t const now, std::string& line)
+{
+	line.clear();
+
+	if (st.srv.state == STATE_FAIL)
+	{
+		line += ControlError(st.srv.error);
+	}
+	else
+	{
+		StatusFormatFlags(st.srv, line);
+
+		if (line.size() > 0)
+		{
+			// Without the first ", ".
+			line.erase(0, 2);
+		}
+	}
+
+	if (st.hasLog)
+	{
+		line += (line.size() > 0) ? "; " : "";
+		StatusFormatSupervise(st.log, "log", ": ", now, line);
+	}
+}
+
+
+#ifdef IGNORE_RUN_SERVICES
+bool FindIgnoreService(char const* const path)
+{
+	bool ret = false;
+	//MESSAGE_DBG("%s %s", IGNORE_RUN_SERVICES, path);
+	char *copy = strdup(IGNORE_RUN_SERVICES);
+	ASSERT(copy != NULL);
+	char *t = strtok(copy,":");
+	while (t != NULL)
+	{
+		if (strstr(path, t) != NULL)
+		{
+			ret = true;
+			break;
+		}
+		t = strtok(NULL,":");
+	}
+	free(copy);
+	return ret;
+}
+#endif
@@ -0,0 +1,88 @@
+/*
+	Copyright 2026 Daniel T. Borelli <danieltborelli@gmail.com>
+
+	This file is part of xrunit.
+
+	xrunit is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	xrunit is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with xrunit.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef STATUS_H_INCLUDE
+#define STATUS_H_INCLUDE
+
+/*
+ * Native reader of the runsv 'supervise/status' record.
+ * Does not use fltk, it is also used outside the GUI.
+ */
+
+#define STATUS_RECORD_SZ 20
+
+enum {
+	STATE_DOWN = 0,
+	STATE_RUN,
+	STATE_FINISH,
+	/* runsv not running or the record could not be read */
+	STATE_FAIL,
+	STATE_MAX,
+};
+
+struct SuperviseStatus
+{
+	time_t since;
+	pid_t pid;
+	int state;
+	int error;        /* errno when state == STATE_FAIL */
+	bool paused;
+	bool wantUp;
+	bool wantDown;
+	bool gotTerm;
+	bool normallyUp;
+};
+
+struct ServiceStatus
+{
+	std::string name;
+	std::string path; /* SV_RUN_DIR/name */
+	SuperviseStatus srv;
+	SuperviseStatus log;
+	bool hasLog;
+	int root;         /* index of its run directory, see StatusScanRoots */
+};
+
+typedef std::vector<ServiceStatus> StatusSnapshot;
+
+char const* StatusStateName(int const state);
+
+bool StatusReadSupervise(int const dirfd, char const* const dir, SuperviseStatus* const st);
+
+void StatusReadService(ServiceStatus* const st);
+
+bool StatusScan(char const* const runDir, StatusSnapshot& snap);
+
+/*
+ * With more than one extra root each one is scanned on its own thread,
+ * a single extra root after roots[0] on the caller. The services of roots[0] are
+ * named as in StatusScan, the others by their path. Only a failure of
+ * roots[0] is an error.
+ */
+bool StatusScanRoots(std::vector<std::string> const& roots, StatusSnapshot& snap);
+
+void StatusFormat(ServiceStatus const& st, time_t const now, std::string& line);
+
+void StatusFormatDetail(ServiceStatus const& st, time_t const now, std::string& line);
+
+#ifdef IGNORE_RUN_SERVICES
+bool FindIgnoreService(char const* const path);
+#endif
+
+#endif
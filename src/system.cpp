@@ -18,106 +18,30 @@
 */
 #include "config.h"
 #include "system.h"
+#include "launch.h"
 
-void System(char const* const exec, char* const* argv)
-{
-	int wpid = 0, status = 0;
-
-	SanitizeEnv();
+/* The child of each PipeOpen, for PipeClose. */
+static std::unordered_map<FILE*, pid_t> pipeChild;
 
-	if (fork() == 0)
-	{
-		errno = 0;
-
-		int ret = execvp(exec, argv);
-
-		if (ret == -1)
-		{
-			STOP("There was a failure while executing the process %s, error=%s\n", exec, strerror(errno));
-		}
-
-		if (127 == WEXITSTATUS(ret))
-		{
-			STOP("The command could not be executed:\n%s", exec);
-		}
-
-		if (WIFEXITED(ret))
-		{
-			if (WEXITSTATUS(ret) != 0)
-			{
-				STOP("The command was executed but ended with error.\n%s", exec);
-			}
-		}
-
-		exit(EXIT_SUCCESS);
-	}
-
-	while ((wpid = wait(&status)) > 0);
-}
-
-
-void SanitizeEnv(void)
+void System(char const* const exec, char* const* argv)
 {
-	char* display = getenv("DISPLAY");
-
-	ASSERT_STRING(display);
-
-	char* xauthority = getenv("XAUTHORITY");
-
-	ASSERT_STRING(xauthority);
-
-	if (clearenv() != 0)
-	{
-		STOP("clearenv() function failed");
-	}
-
-	size_t const n = confstr(_CS_PATH, 0, 0);
-
-	if (n == 0)
-	{
-		STOP("confstr(_CS_PATH, 0, 0) function failed");
-	}
-
-	char* pathbuf = (char*)calloc(n, sizeof(char));
+	ASSERT_DBG_STRING(exec);
 
-	ASSERT_DBG(pathbuf);
+	int status = 0;
 
-	if (confstr(_CS_PATH, pathbuf, n) == 0)
-	{
-		free(pathbuf);
-		STOP("confstr(_CS_PATH, pathbuf, n) function failed");
-	}
+	pid_t const pid = LaunchSpawn(exec, argv, -1, NULL);
 
-	errno = 0;
-
-	if (setenv("PATH", pathbuf, 1) == -1)
+	if (pid == -1)
 	{
-		free(pathbuf);
-		STOP("setenv(PATH) function failed: %s", strerror(errno));
-	}
-
-	free(pathbuf);
-	pathbuf = (char*)NULL;
-
-	errno = 0;
-
-	if (setenv("IFS", "\t\n", 1) == -1)
-	{
-		STOP("setenv(IFS) function failed: %s", strerror(errno));
-	}
-
-	errno = 0;
-
-	if (setenv("DISPLAY", display, 1) == -1)
-	{
-		STOP("setenv(DISPLAY) function failed: %s", strerror(errno));
+		WARNING("There was a failure while executing the process %s, error=%s\n", exec, strerror(errno));
+		return;
 	}
 
-	errno = 0;
+	while (waitpid(pid, &status, 0) == -1 && errno == EINTR);
 
-	if (setenv("XAUTHORITY", xauthority, 1) == -1)
+	if (WIFEXITED(status) && WEXITSTATUS(status) != 0)
 	{
-		STOP("setenv(XAUTHORITY) function failed: %s", strerror(errno));
+		WARNING("The command was executed but ended with error.\n%s", exec);
 	}
 }
 
@@ -229,9 +153,25 @@ FILE* PipeOpen(char const* const cmd)
 {
 	ASSERT_DBG_STRING(cmd);
 
-	SanitizeEnv();
+	int fd[2];
 
-	FILE* pipe = popen(cmd, "r");
+	FILE* pipe = NULL;
+	pid_t pid = -1;
+
+	if (pipe2(fd, O_CLOEXEC) == 0)
+	{
+		char* argv[] = { (char*)"sh", (char*)"-c", (char*)cmd, NULL };
+
+		pid = LaunchSpawn("/bin/sh", argv, fd[1], NULL);
+		close(fd[1]);
+
+		pipe = (pid != -1) ? fdopen(fd[0], "r") : NULL;
+
+		if (!pipe)
+		{
+			close(fd[0]);
+		}
+	}
 
 	if (!pipe)
 	{
@@ -239,6 +179,8 @@ FILE* PipeOpen(char const* const cmd)
 		exit(EXIT_FAILURE);
 	}
 
+	pipeChild[pipe] = pid;
+
 	return pipe;
 }
 
@@ -246,26 +188,20 @@ FILE* PipeOpen(char const* const cmd)
 void PipeClose(FILE* pipe)
 {
 	ASSERT_DBG(pipe);
-	pclose(pipe);
-}
 
+	auto const child = pipeChild.find(pipe);
 
-void FileToExecutableMode(char const* const fileName)
-{
-	ASSERT_DBG_STRING(fileName);
+	ASSERT_DBG(child != pipeChild.end());
 
-	errno = 0;
+	pid_t const pid = child->second;
 
-	mode_t const user = S_IRUSR | S_IWUSR | S_IXUSR;
-	mode_t const group = S_IXGRP | S_IRGRP;
-	mode_t const other = S_IXOTH | S_IROTH;
+	pipeChild.erase(child);
+	fclose(pipe);
 
-	if (-1 == chmod(fileName,  user | group | other))
-	{
-		fl_alert("File mode change failed: %s\nError:%s", fileName, strerror(errno));
-	}
+	while (waitpid(pid, NULL, 0) == -1 && errno == EINTR);
 }
 
+
 bool MakeDir(char const* const dirName, bool showError)
 {
 	ASSERT_DBG_STRING(dirName);
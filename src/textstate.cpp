@@ -0,0 +1,188 @@
+/*
+	Copyright 2026 Daniel T. Borelli <danieltborelli@gmail.com>
+
+	This file is part of xrunit.
+
+	xrunit is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	xrunit is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with xrunit.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "config.h"
+#include "textstate.h"
+
+
+#define TEXT_HASH_BASE 0x100000001B3ULL     /* odd, so it has an inverse mod 2^64 */
+
+
+static inline unsigned long long TextMix(unsigned char const c)
+{
+	unsigned long long x = (c + 1ULL) * 0x9E3779B97F4A7C15ULL;
+
+	x ^= x >> 31;
+	x *= 0xBF58476D1CE4E5B9ULL;
+
+	return x ^ (x >> 29);
+}
+
+
+static unsigned long long TextPow(unsigned long long base, unsigned int exp)
+{
+	unsigned long long x = 1;
+
+	for (; exp > 0; exp >>= 1, base *= base)
+	{
+		if (exp & 1)
+		{
+			x *= base;
+		}
+	}
+
+	return x;
+}
+
+
+/* B^-1 mod 2^64, each Newton step doubles the correct low bits. */
+static unsigned long long TextBaseInverse(void)
+{
+	unsigned long long x = TEXT_HASH_BASE;
+
+	for (int i = 0; i < 6; ++i)
+	{
+		x *= 2 - TEXT_HASH_BASE * x;
+	}
+
+	return x;
+}
+
+
+/* Hash of the bytes [from, to) of the buffer, as if 'from' were position 0. */
+static unsigned long long TextHashRange(Fl_Text_Buffer const* const buffer, int from, int const to)
+{
+	unsigned long long hash = 0;
+	unsigned long long power = 1;
+
+	for (; from < to; ++from, power *= TEXT_HASH_BASE)
+	{
+		hash += TextMix(buffer->byte_at(from)) * power;
+	}
+
+	return hash;
+}
+
+
+static inline bool TextBlank(char const c)
+{
+	return c == ' ' || c == '\n';
+}
+
+
+static void TextStateModifyCb(int pos, int nInserted, int nDeleted, UNUSED int nRestyled,
+	char const* deletedText, void* data)
+{
+	TextState& ts = *(TextState*)data;
+
+	if (nInserted == 0 && nDeleted == 0)
+	{
+		return;
+	}
+
+	static unsigned long long const inverse = TextBaseInverse();
+
+	Fl_Text_Buffer const* const buffer = ts.buffer;
+	int const length = buffer->length();
+
+	ASSERT_DBG(nDeleted == 0 || deletedText != NULL);
+
+	// The text was head + deleted + tail, it is head + inserted + tail.
+	unsigned long long deleted = 0;
+	unsigned long long power = 1;
+
+	for (int i = 0; i < nDeleted; ++i, power *= TEXT_HASH_BASE)
+	{
+		deleted += TextMix(deletedText[i]) * power;
+		ts.nonBlank -= TextBlank(deletedText[i]) ? 0 : 1;
+	}
+
+	for (int i = 0; i < nInserted; ++i)
+	{
+		ts.nonBlank += TextBlank(buffer->byte_at(pos + i)) ? 0 : 1;
+	}
+
+	unsigned long long const inserted = TextHashRange(buffer, pos, pos + nInserted);
+	unsigned long long const atPos = TextPow(TEXT_HASH_BASE, pos);
+	unsigned long long head;
+	unsigned long long tail;
+
+	if (pos <= length - pos - nInserted)
+	{
+		head = TextHashRange(buffer, 0, pos);
+		tail = (ts.hash - head - atPos * deleted) * TextPow(inverse, pos + nDeleted);
+	}
+	else
+	{
+		tail = TextHashRange(buffer, pos + nInserted, length);
+		head = ts.hash - atPos * deleted - TextPow(TEXT_HASH_BASE, pos + nDeleted) * tail;
+	}
+
+	ts.hash = head + atPos * inserted + TextPow(TEXT_HASH_BASE, pos + nInserted) * tail;
+}
+
+
+void TextStateAttach(TextState& ts, Fl_Text_Buffer* const buffer)
+{
+	ASSERT_DBG(buffer);
+	ASSERT_DBG(buffer->length() == 0);
+
+	ts.buffer = buffer;
+	ts.hash = 0;
+	ts.originalHash = 0;
+	ts.originalLength = 0;
+	ts.nonBlank = 0;
+	ts.tracking = false;
+
+	buffer->add_modify_callback(TextStateModifyCb, (void*)&ts);
+}
+
+
+void TextStateDetach(TextState& ts)
+{
+	ASSERT_DBG(ts.buffer);
+
+	ts.buffer->remove_modify_callback(TextStateModifyCb, (void*)&ts);
+	ts.buffer = NULL;
+}
+
+
+void TextStateReset(TextState& ts)
+{
+	ASSERT_DBG(ts.buffer);
+
+	ts.originalHash = ts.hash;
+	ts.originalLength = ts.buffer->length();
+	ts.tracking = true;
+}
+
+
+bool TextStateEmpty(TextState const& ts)
+{
+	return ts.nonBlank == 0;
+}
+
+
+bool TextStateDirty(TextState const& ts)
+{
+	ASSERT_DBG(ts.buffer);
+
+	return ts.tracking
+		&& (ts.hash != ts.originalHash || ts.buffer->length() != ts.originalLength);
+}
@@ -0,0 +1,52 @@
+/*
+	Copyright 2026 Daniel T. Borelli <danieltborelli@gmail.com>
+
+	This file is part of xrunit.
+
+	xrunit is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	xrunit is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with xrunit.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef TEXTSTATE_H_INCLUDE
+#define TEXTSTATE_H_INCLUDE
+
+/*
+ * Dirty and empty state of a Fl_Text_Buffer kept by its modify callback.
+ * The text is hashed by position, sum of mix(byte) * B^pos mod 2^64, and
+ * each edit rehashes only itself and the shorter side around it, the
+ * other side is moved by a power of B. The text is dirty when its hash
+ * or its length differs from the ones it had after loading.
+ */
+
+struct TextState
+{
+	Fl_Text_Buffer* buffer;
+	unsigned long long hash;
+	unsigned long long originalHash;
+	int originalLength;
+	int nonBlank;                /* bytes other than ' ' and '\n' */
+	bool tracking;               /* since TextStateReset */
+};
+
+void TextStateAttach(TextState& ts, Fl_Text_Buffer* const buffer);
+
+void TextStateDetach(TextState& ts);
+
+/* The current text is the original, after loading it. */
+void TextStateReset(TextState& ts);
+
+bool TextStateEmpty(TextState const& ts);
+
+bool TextStateDirty(TextState const& ts);
+
+#endif
@@ -0,0 +1,257 @@
+/*
+	Copyright 2026 Daniel T. Borelli <danieltborelli@gmail.com>
+
+	This file is part of xrunit.
+
+	xrunit is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	xrunit is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with xrunit.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "config.h"
+#include "watch.h"
+
+#include <sys/inotify.h>
+#include <unordered_map>
+
+/* runsv writes 'status.new' and renames it to 'status'. */
+#define WATCH_SUPERVISE_MASK (IN_MOVED_TO | IN_CLOSE_WRITE)
+
+#define WATCH_RUN_DIR_MASK (IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO)
+
+/* A service without its supervise directory yet, runsv creates it. */
+#define WATCH_SERVICE_DIR_MASK (IN_CREATE | IN_MOVED_TO)
+
+static int watchFd = -1;
+
+/* Watches of the run directories, a change needs a full scan. */
+static std::vector<int> watchRunDirs;
+
+static std::unordered_map<int, size_t> watchIds;
+
+/* Service and log directories waiting for 'supervise', a full scan adds it. */
+static std::vector<int> watchPending;
+
+
+int WatchOpen(char const* const runDir)
+{
+	ASSERT_DBG_STRING(runDir);
+	ASSERT_DBG(watchFd == -1);
+
+	errno = 0;
+
+	watchFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+
+	if (watchFd == -1)
+	{
+		WARNING("inotify_init1 failed: %s", strerror(errno));
+		return -1;
+	}
+
+	if (!WatchAddRoot(runDir))
+	{
+		WatchClose();
+		return -1;
+	}
+
+	return watchFd;
+}
+
+
+bool WatchAddRoot(char const* const runDir)
+{
+	ASSERT_DBG_STRING(runDir);
+	ASSERT_DBG(watchFd != -1);
+
+	int const wd = inotify_add_watch(watchFd, runDir, WATCH_RUN_DIR_MASK);
+
+	if (wd == -1)
+	{
+		WARNING("inotify_add_watch '%s' failed: %s", runDir, strerror(errno));
+		return false;
+	}
+
+	watchRunDirs.push_back(wd);
+
+	return true;
+}
+
+
+void WatchClose(void)
+{
+	if (watchFd != -1)
+	{
+		close(watchFd);
+	}
+
+	watchFd = -1;
+	watchRunDirs.clear();
+	watchIds.clear();
+	watchPending.clear();
+}
+
+
+void WatchReset(void)
+{
+	for (auto const& it : watchIds)
+	{
+		inotify_rm_watch(watchFd, it.first);
+	}
+
+	for (int const wd : watchPending)
+	{
+		inotify_rm_watch(watchFd, wd);
+	}
+
+	watchIds.clear();
+	watchPending.clear();
+}
+
+
+/* 'dir/supervise', or 'dir' until runsv creates it. */
+static int WatchSupervise(char const* const dir, bool const pending)
+{
+	std::string path = dir;
+	path += "/supervise";
+
+	int wd = inotify_add_watch(watchFd, path.c_str(), WATCH_SUPERVISE_MASK);
+
+	if (wd != -1 || !pending)
+	{
+		return wd;
+	}
+
+	int const wdDir = inotify_add_watch(watchFd, dir, WATCH_SERVICE_DIR_MASK);
+
+	if (wdDir == -1)
+	{
+		return -1;
+	}
+
+	// Created between both calls, no event will come for it.
+	wd = inotify_add_watch(watchFd, path.c_str(), WATCH_SUPERVISE_MASK);
+
+	if (wd != -1)
+	{
+		inotify_rm_watch(watchFd, wdDir);
+		return wd;
+	}
+
+	watchPending.push_back(wdDir);
+
+	return -1;
+}
+
+
+/*
+ * Watch 'dir/supervise', and 'dir/log/supervise' if 'dir/log' exists.
+ * Without them yet, their creation asks for a full scan in WatchRead.
+ * Returns false when neither can be watched (a dangling link), then
+ * only the run directory and the safety scan notice it.
+ */
+bool WatchAdd(char const* const dir, size_t const id)
+{
+	ASSERT_DBG_STRING(dir);
+	ASSERT_DBG(watchFd != -1);
+
+	size_t const pending = watchPending.size();
+
+	int const wd = WatchSupervise(dir, true);
+
+	if (wd == -1)
+	{
+		return watchPending.size() > pending;
+	}
+
+	watchIds[wd] = id;
+
+	std::string const log = std::string(dir) + "/log";
+
+	struct stat st;
+
+	int const wdLog = WatchSupervise(log.c_str(), stat(log.c_str(), &st) == 0 && S_ISDIR(st.st_mode));
+
+	if (wdLog != -1)
+	{
+		watchIds[wdLog] = id;
+	}
+
+	return true;
+}
+
+
+/*
+ * Collects the identifiers whose status changed.
+ * Returns true when SV_RUN_DIR changed, or runsv created a supervise
+ * directory, and a full scan is needed.
+ */
+bool WatchRead(std::vector<size_t>& changed)
+{
+	ASSERT_DBG(watchFd != -1);
+
+	alignas(struct inotify_event) char buffer[4096];
+
+	bool rescan = false;
+
+	changed.clear();
+
+	for (;;)
+	{
+		ssize_t const n = read(watchFd, buffer, sizeof(buffer));
+
+		if (n <= 0)
+		{
+			break;
+		}
+
+		for (char* p = buffer; p < buffer + n; )
+		{
+			struct inotify_event const* ev = (struct inotify_event const*)p;
+
+			p += sizeof(struct inotify_event) + ev->len;
+
+			if (ev->mask & IN_Q_OVERFLOW)
+			{
+				rescan = true;
+			}
+			else if (std::find(watchRunDirs.begin(), watchRunDirs.end(), ev->wd) != watchRunDirs.end())
+			{
+				rescan = true;
+			}
+			else if (std::find(watchPending.begin(), watchPending.end(), ev->wd) != watchPending.end())
+			{
+				if (ev->mask & IN_IGNORED)
+				{
+					watchPending.erase(std::find(watchPending.begin(), watchPending.end(), ev->wd));
+				}
+				else if (ev->len > 0 && strcmp(ev->name, "supervise") == 0)
+				{
+					rescan = true;
+				}
+			}
+			else if (ev->mask & IN_IGNORED)
+			{
+				watchIds.erase(ev->wd);
+			}
+			else if (ev->len > 0 && strcmp(ev->name, "status") == 0)
+			{
+				auto const it = watchIds.find(ev->wd);
+
+				if (it != watchIds.end())
+				{
+					changed.push_back(it->second);
+				}
+			}
+		}
+	}
+
+	return rescan;
+}
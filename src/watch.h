@@ -0,0 +1,44 @@
+/*
+	Copyright 2026 Daniel T. Borelli <danieltborelli@gmail.com>
+
+	This file is part of xrunit.
+
+	xrunit is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	xrunit is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with xrunit.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef WATCH_H_INCLUDE
+#define WATCH_H_INCLUDE
+
+/*
+ * inotify watches over SV_RUN_DIR and the 'supervise' directory
+ * of each service. Each service watch carries an identifier
+ * given by the caller (the index in the StatusSnapshot).
+ * A service without 'supervise' yet is watched for its creation,
+ * no polling is needed while runsv starts.
+ */
+
+int WatchOpen(char const* const runDir);
+
+/* One more run directory, see StatusScanRoots. */
+bool WatchAddRoot(char const* const runDir);
+
+void WatchClose(void);
+
+void WatchReset(void);
+
+bool WatchAdd(char const* const dir, size_t const id);
+
+bool WatchRead(std::vector<size_t>& changed);
+
+#endif
@@ -20,12 +20,34 @@
 #include "config.h"
 #include "notify.h"
 #include "system.h"
+#include "status.h"
+#include "watch.h"
+#include "exec.h"
+#include "launch.h"
+#include "deps.h"
+#include "control.h"
+#include "history.h"
+#include "procstat.h"
+#include "proctree.h"
+#include "proctreeview.h"
+#include "registry.h"
+#include "cli.h"
+#include "daemon.h"
+#include "client.h"
+#include "perf.h"
+#include "logview.h"
+#include "logmerge.h"
+#include "servicetable.h"
+#include "fuzzy.h"
+#include "textstate.h"
+#include "savebatch.h"
 #include "icons.h"
 
-void FillBrowserEnable(void);
+void FillServiceTable(void);
 void FillBrowserList(void);
+void ShowBrowserList(void);
 int GetSelected(Fl_Browser const* const brw);
-void RunSv(char const* const service, char const* const action);
+void RunSv(std::vector<std::string> const& services, char const* const action, int const notifyId);
 void ShowWindowModal(Fl_Double_Window* const wnd);
 void SetButtonAlign(int const start, int const end, int const align, Fl_Button* btns[]);
 void SetButtonFont(int const start, int const end, Fl_Button* btns[]);
@@ -34,6 +56,7 @@ void SetFont(Fl_Hold_Browser* w);
 void SetFont(Fl_Text_Editor* w);
 void RemoveNewLine(std::string& str);
 bool AskIfContinue(char const* const service);
+bool AskIfContinue(std::vector<std::string> const& services);
 void MakeServicePath(std::string const& service, std::string& path);
 void MakeServiceRunDirPath(std::string const& service, std::string& path);
 void MakeLogDirPath(std::string const& service, std::string& path);
@@ -42,27 +65,43 @@ void ShowNotify(int const id, char const* const service);
 #endif
 char* ExtractServiceNameFromPath(char const* const service);
 char* ExtractServiceNameFromSV(char const* const service);
-#ifdef IGNORE_RUN_SERVICES
-bool FindIgnoreService(char const* const path);
-#endif
 
 void QuitCb(UNUSED Fl_Widget* w, UNUSED void* data);
 void SelectCb(Fl_Widget* w, UNUSED void* data);
+void FilterCb(Fl_Widget* w, UNUSED void* data);
 void CommandSrvCb(Fl_Widget* w, UNUSED void* data);
 void CommandLogCb(Fl_Widget* w, void* data);
-void Command(Fl_Button const* const btnId, char const* const service);
+void SignalSrvCb(UNUSED Fl_Widget* w, void* data);
+void LogViewCb(UNUSED Fl_Widget* w, UNUSED void* data);
+void LogMergeCb(UNUSED Fl_Widget* w, UNUSED void* data);
+void ProcTreeCb(UNUSED Fl_Widget* w, UNUSED void* data);
+void DepsCb(UNUSED Fl_Widget* w, void* data);
+void Command(Fl_Button const* const btnId, std::vector<std::string> const& services);
 void LoadUnloadCb(Fl_Widget* w, UNUSED void* data);
 void AddServicesCb(UNUSED Fl_Widget* w, void* data);
 void TimerCb(UNUSED void* data);
+void UptimeTimerCb(UNUSED void* data);
+void ProcTimerCb(UNUSED void* data);
 void EditNewCb(Fl_Widget* w, void* data);
 void DeleteServiceCb(UNUSED Fl_Widget* w, void* data);
 void EnabledDisabledServiceCb(Fl_Widget* w, void* data);
 
-static int itemSelect[BROWSER_MAX] { [ENABLE] = SELECT_RESET, [LIST] = SELECT_RESET };
+static int itemSelect[BROWSER_MAX] { [LIST] = SELECT_RESET };
 
 static Fl_Hold_Browser* browser[BROWSER_MAX];
+static ServiceTable* serviceTable;
+static Fl_Input* filterServices;
+static Fl_Input* filterList;
+static FuzzyFilter fuzzyServices;
+static FuzzyFilter fuzzyList;
+/* Available services of browser[LIST], by name. */
+static std::vector<size_t> listIds;
+static Fl_Box* lblStatus;
+static Fl_Menu_Button* menuSignal;
+static Fl_Menu_Button* menuLog;
 static Fl_Button* btn[BTN_MAX];
 static Fl_Text_Buffer* tbuf[TBUF_MAX];
+static TextState tstate[TBUF_MAX];
 static Fl_Text_Editor* tedt[TEDT_MAX];
 
 static char const* STR_LOAD = "Load";
@@ -71,8 +110,59 @@ static char const* STR_EDIT = "Edit...";
 static char const* STR_NEW = "New...";
 static char const* SV_DIR_SELECT = NULL;
 
+static char const* SV_RUN_DIR_SELECT = NULL;
+/* SV_RUN_DIR_SELECT and the other run directories of SVRUNDIR. */
+static std::vector<std::string> runRoots;
+static char const* XRUNITD_SOCKET_SELECT = NULL;
+static StatusSnapshot statusSnapshot;
+
+static int watchFd = -1;
+/* Connected to xrunitd, which reads the status and runs the commands. */
+static int clientFd = -1;
+static ClientState clientState;
+static bool procSampling = false;
+
+/* Right click over the services table. */
+static Fl_Menu_Item serviceMenu[] =
+{
+	{ "Process tree...", 0, ProcTreeCb, NULL, 0, 0, 0, 0, 0 },
+	{ "View log...", 0, LogViewCb, NULL, 0, 0, 0, 0, 0 },
+	{ "Start with dependencies", 0, DepsCb, (void*)"start", 0, 0, 0, 0, 0 },
+	{ "Stop with dependents", 0, DepsCb, (void*)"stop", 0, 0, 0, 0, 0 },
+	{ NULL, 0, NULL, NULL, 0, 0, 0, 0, 0 }
+};
+
+/* The waves of the last 'Start with dependencies' or 'Stop with dependents'. */
+static DepsRun depsRun;
+static bool depsActive = false;
+
+static void ShowServiceTable(void);
+static Fl_Image* GetStateIcon(int const state, bool const warning);
+static void ShowPerf(void);
+static void SampleServices(void);
+static void WatchServices(void);
+static void WatchStart(void);
+static void ClientStart(char const* const socketPath);
+static void ShowSvJobs(void);
+static void MakeSysLogDirPath(std::string const& service, std::string& path);
+
+/* Times its flush for the perf status bar. */
+class MainWindow : public Fl_Double_Window
+{
+public:
+	MainWindow(int const w, int const h) : Fl_Double_Window(w, h) { }
+
+	void flush(void)
+	{
+		PERF_BEGIN(start);
+		Fl_Double_Window::flush();
+		PERF_END(PERF_REDRAW, start);
+	}
+};
+
 static void Exit(void)
 {
+	WatchClose();
 	NotifyEnd();
 }
 
@@ -90,29 +180,120 @@ static void SetSvdirFromEnv()
 	}
 }
 
+/* Like PATH: SVRUNDIR=/run/runit/service:/home/user/.local/service */
+static void SetSvRunDirFromEnv()
+{
+	char const* const svrundirenv = secure_getenv("SVRUNDIR");
+
+	if (svrundirenv != NULL)
+	{
+		char const* start = svrundirenv;
+
+		for (char const* p = svrundirenv; ; ++p)
+		{
+			if (*p == ':' || *p == '\0')
+			{
+				// The services of the others are named by their path.
+				if (!runRoots.empty() && p > start && *start != '/')
+				{
+					WARNING("SVRUNDIR: '%.*s' is not an absolute path, ignored", (int)(p - start), start);
+				}
+				else if (p > start && p - start < PATH_MAX)
+				{
+					runRoots.push_back(std::string(start, p - start));
+				}
+
+				if (*p == '\0')
+				{
+					break;
+				}
+
+				start = p + 1;
+			}
+		}
+	}
+
+	if (runRoots.empty())
+	{
+		runRoots.push_back(SV_RUN_DIR);
+	}
+
+	SV_RUN_DIR_SELECT = strdup(runRoots[0].c_str());
+}
+
+static void SetSocketFromEnv()
+{
+	char const* const socketenv = secure_getenv("XRUNITSOCK");
+
+	if (socketenv != NULL)
+	{
+		XRUNITD_SOCKET_SELECT = strndup(socketenv, PATH_MAX);
+	}
+	else
+	{
+		XRUNITD_SOCKET_SELECT = XRUNITD_SOCKET;
+	}
+}
+
+/* F12 shows or hides the timings in the status bar. */
+static int PerfKeyHandler(int const event)
+{
+	if (event != FL_SHORTCUT || Fl::event_key() != FL_F + 12)
+	{
+		return 0;
+	}
+
+	PerfEnable(!perfEnabled);
+	ShowPerf();
+
+	return 1;
+}
+
 
 int main(int argc, char* argv[])
 {
 	ASSERT((TIME_UPDATE > 1) && (TIME_UPDATE < 100));
+	ASSERT((TIME_SAFETY >= TIME_UPDATE) && (TIME_SAFETY <= 3600));
+	ASSERT((TIME_PROC >= 1) && (TIME_PROC <= 60));
 	ASSERT((FONT >= 0) && (FONT < SSIZE_MAX));
 	ASSERT((FONT_SZ >= 8) && (FONT_SZ <= 14));
 	ASSERT((strlen(SV_DIR) > 0) && (strlen(SV_DIR) < STR_SZ));
 	ASSERT((strlen(SV_RUN_DIR) > 0) && (strlen(SV_RUN_DIR) < STR_SZ));
 	ASSERT((strlen(SV) > 0) && (strlen(SV) < STR_SZ));
 	ASSERT((strlen(ASK_SERVICES) > 0) && (strlen(ASK_SERVICES) < STR_SZ));
+	ASSERT((BATCH_JOBS > 0) && (BATCH_JOBS <= 64));
+	ASSERT((DEPS_TIMEOUT > 0) && (DEPS_TIMEOUT <= 3600));
 	ASSERT((strlen(SYS_LOG_DIR) > 0) && (strlen(SYS_LOG_DIR) < STR_SZ));
 #ifdef IGNORE_RUN_SERVICES
 	ASSERT((strlen(IGNORE_RUN_SERVICES) > 0) && (strlen(IGNORE_RUN_SERVICES) < STR_SZ));
 #endif
 
 	SetSvdirFromEnv();
+	SetSvRunDirFromEnv();
+	SetSocketFromEnv();
 
 	MESSAGE_DBG("TITLE: %s", TITLE);
 	MESSAGE_DBG("TIME_UPDATE: %d", TIME_UPDATE);
+	MESSAGE_DBG("TIME_SAFETY: %d", TIME_SAFETY);
 	MESSAGE_DBG("SV: %s", SV);
 	MESSAGE_DBG("SV_DIR: %s", SV_DIR_SELECT);
-	MESSAGE_DBG("SV_RUN_DIR: %s", SV_RUN_DIR);
+	MESSAGE_DBG("SV_RUN_DIR: %s", SV_RUN_DIR_SELECT);
 	MESSAGE_DBG("SYS_LOG_DIR: %s", SYS_LOG_DIR);
+	MESSAGE_DBG("XRUNITD_SOCKET: %s", XRUNITD_SOCKET_SELECT);
+
+	if (DaemonIsCommand(argc, argv))
+	{
+		return DaemonRun(SV_RUN_DIR_SELECT, XRUNITD_SOCKET_SELECT);
+	}
+
+	// Without permissions, through xrunitd if it is running.
+	char const* const socketPath = (geteuid() != 0 && access(XRUNITD_SOCKET_SELECT, F_OK) == 0)
+		? XRUNITD_SOCKET_SELECT : NULL;
+
+	if (CliIsCommand(argc, argv))
+	{
+		return CliRun(argc, argv, SV_DIR_SELECT, SV_RUN_DIR_SELECT, socketPath);
+	}
 
 	if (argc == 2)
 	{
@@ -125,15 +306,23 @@ int main(int argc, char* argv[])
 
 	fl_message_title_default(TITLE);
 
-	if (geteuid() != 0)
+	if (socketPath != NULL)
 	{
-		fl_alert("Administrator permissions are required");
+		ClientStart(socketPath);
+	}
+	else if (geteuid() != 0)
+	{
+		fl_alert("Administrator permissions are required, or xrunitd running (xrunit --daemon)");
 		exit(EXIT_FAILURE);
 	}
 
+	LaunchInit();
+
 	fl_register_images();
 
-	Fl_Double_Window* wnd = new Fl_Double_Window(600, 400);
+	PerfEnable(secure_getenv("XRUNIT_PERF") != NULL);
+
+	Fl_Double_Window* wnd = new MainWindow(700, 400);
 	Fl_Group* grp = new Fl_Group(0, 0, wnd->w(), 30);
 	btn[QUIT] = new Fl_Button(BTN_X, BTN_Y, BTN_W, BTN_H, "Quit");
 	btn[RUN] = new Fl_Button(BTN_W + BTN_PAD, BTN_Y, BTN_W, BTN_H, "Run");
@@ -159,8 +348,39 @@ int main(int argc, char* argv[])
 	btn[KILL]->callback(CommandSrvCb);
 	btn[ADD]->callback(AddServicesCb,(void*)wnd);
 
-	{
-		Fl_Box *o = new Fl_Box(BTN_W * 7 + BTN_PAD, 0, 10, 10);
+	// xrunitd only runs the commands, editing and the 'check' of the services need permissions.
+	if (clientFd != -1)
+	{
+		btn[ADD]->deactivate();
+		serviceMenu[2].deactivate();
+		serviceMenu[3].deactivate();
+	}
+
+	menuSignal = new Fl_Menu_Button(BTN_W * 6 + BTN_PAD + 22, BTN_Y, BTN_W, BTN_H, "Signal");
+	menuSignal->add("Term", 0, SignalSrvCb, (void*)"term");
+	menuSignal->add("Hup", 0, SignalSrvCb, (void*)"hup");
+	menuSignal->add("Interrupt", 0, SignalSrvCb, (void*)"interrupt");
+	menuSignal->add("Alarm", 0, SignalSrvCb, (void*)"alarm");
+	menuSignal->add("Quit", 0, SignalSrvCb, (void*)"quit");
+	menuSignal->add("Usr1", 0, SignalSrvCb, (void*)"1");
+	menuSignal->add("Usr2", 0, SignalSrvCb, (void*)"2", FL_MENU_DIVIDER);
+	menuSignal->add("Pause", 0, SignalSrvCb, (void*)"pause");
+	menuSignal->add("Cont", 0, SignalSrvCb, (void*)"cont");
+	menuSignal->add("Once", 0, SignalSrvCb, (void*)"once");
+	menuSignal->add("Exit runsv", 0, SignalSrvCb, (void*)"exit");
+	SetFont(menuSignal);
+	menuSignal->textfont(FONT);
+	menuSignal->textsize(FONT_SZ);
+
+	menuLog = new Fl_Menu_Button(BTN_W * 7 + BTN_PAD + 24, BTN_Y, BTN_W, BTN_H, "Log");
+	menuLog->add("View...", 0, LogViewCb);
+	menuLog->add("Merge selected...", 0, LogMergeCb);
+	SetFont(menuLog);
+	menuLog->textfont(FONT);
+	menuLog->textsize(FONT_SZ);
+
+	{
+		Fl_Box *o = new Fl_Box(BTN_W * 8 + BTN_PAD + 26, 0, 2, 10);
 		o->box(FL_FLAT_BOX);
 		o->hide();
 		grp->resizable(o);
@@ -168,28 +388,51 @@ int main(int argc, char* argv[])
 
 	grp->end();
 
-	browser[ENABLE] = new Fl_Hold_Browser(4, 40, wnd->w() - 8, wnd->h() - 48);
+	filterServices = new Fl_Input(4 + FILTER_LBL_W, 40, wnd->w() - 8 - FILTER_LBL_W, FILTER_H, "Filter:");
+	serviceTable = new ServiceTable(4, 44 + FILTER_H, wnd->w() - 8, wnd->h() - 52 - FILTER_H - LBL_STATUS_H);
+	lblStatus = new Fl_Box(4, wnd->h() - 4 - LBL_STATUS_H, wnd->w() - 8, LBL_STATUS_H);
+	lblStatus->align(Fl_Align(FL_ALIGN_LEFT | FL_ALIGN_INSIDE));
+	SetFont(lblStatus);
 
-	int const columnWidths[] = {
-		100, 150, 0
-	};
+	SetFont(filterServices);
+	filterServices->textfont(FONT);
+	filterServices->textsize(FONT_SZ);
+	filterServices->when(FL_WHEN_CHANGED);
+	filterServices->callback(FilterCb);
 
-	SetFont(browser[ENABLE]);
-	browser[ENABLE]->column_widths(columnWidths);
-	browser[ENABLE]->column_char('\t');
-	browser[ENABLE]->type(FL_MULTI_BROWSER);
-	browser[ENABLE]->callback(SelectCb);
+	serviceTable->StateIcon(GetStateIcon);
+
+	if (clientFd == -1)
+	{
+		serviceTable->Groups(runRoots);
+	}
+	serviceTable->ContextMenu(serviceMenu);
+	serviceTable->callback(SelectCb);
 
-	FillBrowserEnable();
+	FillServiceTable();
 
 	wnd->label(TITLE);
-	wnd->resizable(browser[ENABLE]);
+	wnd->resizable(serviceTable);
 	wnd->end();
 	wnd->show();
 
 	atexit(Exit);
 
-	Fl::add_timeout(TIME_UPDATE, TimerCb);
+	Fl::add_handler(PerfKeyHandler);
+
+	if (clientFd == -1)
+	{
+		WatchStart();
+		Fl::add_timeout((watchFd != -1) ? TIME_SAFETY : TIME_UPDATE, TimerCb);
+	}
+
+	// The full refresh does not run every TIME_UPDATE: with inotify or xrunitd.
+	if (clientFd != -1 || watchFd != -1)
+	{
+		Fl::add_timeout(TIME_UPDATE, UptimeTimerCb);
+	}
+
+	Fl::add_timeout(TIME_PROC, ProcTimerCb);
 
 	return Fl::run();
 }
@@ -226,6 +469,9 @@ void ShowNotify(int const id, char const* const service)
 		case NOTIFY_ALARM:
 			body = NOTIFY_STR_ALARM;
 			break;
+		case NOTIFY_SIGNAL:
+			body = NOTIFY_STR_SIGNAL;
+			break;
 		default:
 			STOP_DBG("Notify identifier not covered: %d", id);
 	}
@@ -272,217 +518,325 @@ void SetButtonFont(int const start, int const end, Fl_Button* btns[])
 	}
 }
 
-#ifdef IGNORE_RUN_SERVICES
-bool FindIgnoreService(char const* const path)
+void FillServiceTable(void)
 {
-	bool ret = false;
-	//MESSAGE_DBG("%s %s", IGNORE_RUN_SERVICES, path);
-	char *copy = strdup(IGNORE_RUN_SERVICES);
-	ASSERT(copy != NULL);
-	char *t = strtok(copy,":");
-	while (t != NULL)
+	PERF_BEGIN(scanStart);
+
+	// xrunitd keeps statusSnapshot up to date.
+	if (clientFd == -1 && !StatusScanRoots(runRoots, statusSnapshot))
 	{
-		if (strstr(path, t) != NULL)
-		{
-			ret = true;
-			break;
-		}
-		t = strtok(NULL,":");
+		fl_alert("Failed to read the services: %s\nError:%s", SV_RUN_DIR_SELECT, strerror(errno));
+		exit(EXIT_FAILURE);
 	}
-	free(copy);
-	return ret;
+
+	PERF_END(PERF_SCAN, scanStart);
+
+	FuzzyClear(fuzzyServices);
+
+	for (ServiceStatus const& st : statusSnapshot)
+	{
+		FuzzyAdd(fuzzyServices, st.name.c_str());
+	}
+
+	PERF_BEGIN(registryStart);
+
+	RegistryUpdateStatus(statusSnapshot);
+
+	PERF_END(PERF_REGISTRY, registryStart);
+
+	if (watchFd != -1)
+	{
+		WatchServices();
+	}
+
+	ShowServiceTable();
 }
-#endif
 
-void FillBrowserEnable(void)
+
+static Fl_Image* GetStateIcon(int const state, bool const warning)
 {
-	char buffer[STR_SZ];
+	if (warning)
+	{
+		return get_icon_warning();
+	}
+
+	switch (state)
+	{
+		case STATE_DOWN:
+			return get_icon_down();
+		case STATE_RUN:
+			return get_icon_run();
+		case STATE_FINISH:
+		case STATE_FAIL:
+			return get_icon_warning();
+		default:
+			STOP_DBG("State not contemplated: %d", state);
+	}
 
-	FILE* pipe = PipeOpen(SV_LIST);
+	return get_icon_warning();
+}
 
-	browser[ENABLE]->clear();
 
+static void SetStatus_CommandButtons(void)
+{
 	btn[DOWN]->deactivate();
 	btn[RUN]->deactivate();
 	btn[ADD]->deactivate();
 	btn[RESTART]->deactivate();
 	btn[KILL]->deactivate();
 
-	int iselect_count = SELECT_RESET;
+	bool const down = (serviceTable->SelectedCount(STATE_DOWN) > 0);
+	bool const run = (serviceTable->SelectedCount(STATE_RUN) > 0);
+
+	if (down)
+	{
+		btn[RUN]->activate();
+		btn[ADD]->activate();
+	}
 
-	while (fgets(buffer, STR_SZ, pipe))
+	if (run)
 	{
-		buffer[STR_SZ - 1] = '\0';
+		btn[DOWN]->activate();
+		btn[RESTART]->activate();
+		btn[ADD]->activate();
+		btn[KILL]->activate();
+	}
+}
 
-		if (!strchr(buffer, '/'))
-		{
-			// Only list services names that are in directory format.
-			continue;
-		}
+
+/* The table keeps its selection and order, only the rows are replaced. */
+static void ShowServiceTable(void)
+{
+	std::vector<uint32_t> ids;
+
+	// Without a filter all the services, by name.
+	FuzzyMatch(fuzzyServices, filterServices->value(), ids);
+
+	bool const filtered = (filterServices->size() > 0);
+
+	std::vector<ServiceRow> rows;
+	rows.reserve(ids.size());
+
+	time_t const now = time(NULL);
+
+	for (size_t i = 0; i < ids.size(); ++i)
+	{
+		ServiceStatus const& st = statusSnapshot[ids[i]];
 #ifdef IGNORE_RUN_SERVICES
-		if (FindIgnoreService(buffer))
+		PERF_BEGIN(ignoreStart);
+
+		bool const ignore = FindIgnoreService(st.path.c_str());
+
+		PERF_ADD(PERF_IGNORE, ignoreStart);
+
+		if (ignore)
 		{
 			// Only non-ignored services.
 			continue;
 		}
 #endif
+		rows.push_back(ServiceRow());
 
+		ServiceRow& row = rows.back();
 
-		char* pb = buffer;
+		row.key = st.name;
+		row.rank = filtered ? (int)i : 0;
+		row.group = st.root;
+		row.state = st.srv.state;
+		row.pid = (st.srv.state == STATE_FAIL) ? 0 : st.srv.pid;
+		row.uptime = (now > st.srv.since) ? (long)(now - st.srv.since) : 0L;
+		StatusFormatDetail(st, now, row.detail);
 
-		if (iselect_count++ == itemSelect[ENABLE])
+		size_t const id = RegistryFind(st.name.c_str());
+
+		if (id != REGISTRY_NONE)
 		{
-			if (pb[0] == 'd' || pb[0] == 'D')
+			Service const& srv = RegistryAt(id);
+
+			HistoryCheck(srv.history, now, row.warning);
+
+			ProcStat const& ps = srv.proc;
+
+			if (ps.valid && ps.pid == row.pid)
 			{
-				btn[RUN]->activate();
-				btn[ADD]->activate();
+				row.sampled = true;
+				row.cpu = ps.cpu;
+				row.rss = ps.rss;
+				row.threads = ps.threads;
+				row.fds = ps.fds;
+				row.readRate = ps.readRate;
+				row.writeRate = ps.writeRate;
 			}
-			else if (pb[0] == 'r' || pb[0] == 'R')
+
+			ProcTreeTotal total;
+
+			if (procSampling && row.pid != 0 && ProcTreeSum(row.pid, total))
 			{
-				btn[DOWN]->activate();
-				btn[RESTART]->activate();
-				btn[ADD]->activate();
-				btn[KILL]->activate();
+				row.tree = true;
+				row.procs = total.procs;
+				row.treeCpu = total.cpu;
+				row.treeRss = total.rss;
 			}
 		}
+	}
 
-		char* pc = strchr(pb, ':');
+#ifdef IGNORE_RUN_SERVICES
+	PERF_COMMIT(PERF_IGNORE);
+#endif
 
-		ASSERT_DBG(pc != (char*)NULL);
-		ASSERT_DBG(*pc != '\0');
+	if (rows.size() == 0 && !filtered)
+	{
+		fl_alert("No runit service found: %s", SV_RUN_DIR_SELECT);
+		exit(EXIT_FAILURE);
+	}
 
-		*pc =  '\t';
+	PERF_BEGIN(rowsStart);
 
-		browser[ENABLE]->add(pb);
+	size_t const changed = serviceTable->Update(rows);
 
-		char pbrk[2] = {pb[0],'\0'};
+	PERF_COUNT(PERF_ROWS_CHANGED, changed);
 
-		/*down:*/
-		if (pb[0] == 'd' || pb[0] == 'D')
-		{
-			browser[ENABLE]->icon(browser[ENABLE]->size(), get_icon_down());
-		}
-		/*run:*/
-		else if (pb[0] == 'r' || pb[0] == 'R')
-		{
-			browser[ENABLE]->icon(browser[ENABLE]->size(), get_icon_run());
-		}
-		/*
-		 * fail:
-		 * warning:
-		 * timeout:
-		 * kill:*/
-		else if (strpbrk(pbrk, "fFwWtTkK") != (char*)NULL)
-		{
-			browser[ENABLE]->icon(browser[ENABLE]->size(), get_icon_warning());
-		}
-		else
-		{
-			STOP_DBG("State not contemplated: %s", pb);
-		}
+	// At start, and when the filter hid the selected services.
+	if (serviceTable->SelectedCount() == 0)
+	{
+		serviceTable->Select(0);
 	}
 
-	PipeClose(pipe);
+	SetStatus_CommandButtons();
 
-	if (browser[ENABLE]->size() == 0)
-	{
-		fl_alert("No runit service found: %s", SV_LIST);
-		exit(EXIT_FAILURE);
-	}
+	PERF_END(PERF_ROWS, rowsStart);
+	PERF_COUNT(PERF_REFRESHES, 1);
 
-	browser[ENABLE]->select(itemSelect[ENABLE]);
-	browser[ENABLE]->middleline(itemSelect[ENABLE]);
+	ShowPerf();
 }
 
 
-static void SetStatus_LoadUnloadButtons(char const* const data)
+static void SetStatus_LoadUnloadButtons(bool const linked)
 {
 	btn[LOAD]->deactivate();
 	btn[UNLOAD]->deactivate();
 
-	if (data == STR_LOAD)
+	if (linked)
 	{
 		btn[UNLOAD]->activate();
 	}
-	else if (data == STR_UNLOAD)
+	else
 	{
 		btn[LOAD]->activate();
 	}
-	else
+}
+
+
+static void SetStatus_LoadUnloadButtons(int const item)
+{
+	char const* const name = browser[LIST]->text(item);
+
+	if (name == NULL)
 	{
-		STOP_DBG("State not contemplated: %s", data);
+		return;
 	}
+
+	size_t const id = RegistryFind(name);
+
+	ASSERT_DBG(id != REGISTRY_NONE);
+
+	SetStatus_LoadUnloadButtons(RegistryAt(id).linked);
 }
 
 
-static void BrowserListSelection_EqualToBrowserEnable(void)
+static void BrowserListSelection_EqualToServiceTable(void)
 {
-	char const* const brwEnableSelectItem = browser[ENABLE]->text(itemSelect[ENABLE]);
+	char const* const current = serviceTable->Current();
 
-	ASSERT_DBG_STRING(brwEnableSelectItem);
+	if (current == NULL)
+	{
+		return;
+	}
 
-	int const size = browser[LIST]->size();
+	size_t const id = RegistryFind(current);
 
-	for (int item = 1; item <= size; ++item)
+	if (id == REGISTRY_NONE || RegistryAt(id).listLine == 0)
 	{
-		char const* const find = browser[LIST]->text(item);
-
-		if (strstr(brwEnableSelectItem, find))
-		{
-			itemSelect[LIST] = item;
-			browser[LIST]->select(item);
-			char* data = (char*)browser[LIST]->data(item);
-			SetStatus_LoadUnloadButtons(data);
-			break;
-		}
+		return;
 	}
+
+	itemSelect[LIST] = RegistryAt(id).listLine;
+	browser[LIST]->select(itemSelect[LIST]);
+	SetStatus_LoadUnloadButtons(itemSelect[LIST]);
 }
 
 
-static void FillBrowserList_All(char const* path)
+static void BrowserListIcon(Service const& srv)
 {
-	browser[LIST]->add(path, (void*)STR_UNLOAD);
-	browser[LIST]->icon(browser[LIST]->size(), get_icon_disable());
+	ASSERT_DBG(srv.listLine > 0);
+
+	browser[LIST]->icon(srv.listLine, srv.linked ? get_icon_enable() : get_icon_disable());
 }
 
 
-static void FillBrowserList_Load(char const* path)
+void FillBrowserList(void)
 {
-	int const size = browser[LIST]->size();
+	PERF_BEGIN(registryStart);
 
-	for (int item = 1; item <= size; ++item)
-	{
-		char const* const find = browser[LIST]->text(item);
+	RegistryScan(SV_DIR_SELECT, SV_RUN_DIR_SELECT);
+
+	PERF_END(PERF_REGISTRY, registryStart);
 
-		if (strstr(path, find))
+	listIds.clear();
+
+	for (size_t id = 0; id < RegistrySize(); ++id)
+	{
+		if (RegistryAt(id).available)
 		{
-			browser[LIST]->icon(item, get_icon_enable());
-			browser[LIST]->data(item, (void*)STR_LOAD);
-			break;
+			listIds.push_back(id);
 		}
 	}
+
+	// Same order as before: reverse of scandir(3) with alphasort.
+	std::sort(listIds.begin(), listIds.end(), [](size_t const a, size_t const b) {
+		return strcoll(RegistryAt(a).name.c_str(), RegistryAt(b).name.c_str()) > 0;
+	});
+
+	FuzzyClear(fuzzyList);
+
+	for (size_t const id : listIds)
+	{
+		FuzzyAdd(fuzzyList, RegistryAt(id).name.c_str());
+	}
+
+	ShowBrowserList();
 }
 
 
-void FillBrowserList(void)
+/* The available services that match the filter, the best first. */
+void ShowBrowserList(void)
 {
-	int iselect_count = SELECT_RESET;
-
 	browser[LIST]->clear();
 
-	ListDirectories(SV_DIR_SELECT, FillBrowserList_All);
+	for (size_t id = 0; id < RegistrySize(); ++id)
+	{
+		RegistryAt(id).listLine = 0;
+	}
+
+	std::vector<uint32_t> ranked;
 
-	ListDirectories(SV_RUN_DIR, FillBrowserList_Load);
+	FuzzyMatch(fuzzyList, filterList->value(), ranked);
 
-	for (int item = 1; item <= browser[LIST]->size(); ++item)
+	for (uint32_t const i : ranked)
 	{
-		if (iselect_count++ == itemSelect[LIST])
-		{
-			char* data = (char*)browser[LIST]->data(item);
-			SetStatus_LoadUnloadButtons(data);
-		}
+		Service& srv = RegistryAt(listIds[i]);
+
+		browser[LIST]->add(srv.name.c_str());
+		srv.listLine = browser[LIST]->size();
+		BrowserListIcon(srv);
+	}
+
+	if (itemSelect[LIST] > browser[LIST]->size())
+	{
+		itemSelect[LIST] = SELECT_RESET;
 	}
 
+	SetStatus_LoadUnloadButtons(itemSelect[LIST]);
 
 	browser[LIST]->select(itemSelect[LIST]);
 }
@@ -504,18 +858,9 @@ int GetSelected(Fl_Browser const* const brw)
 		}
 	}
 
-	int iselected = SELECT_RESET;
+	ASSERT_DBG(brw == browser[LIST]);
 
-	if (brw == browser[ENABLE])
-	{
-		iselected = itemSelect[ENABLE];
-	}
-	else
-	{
-		iselected = itemSelect[LIST];
-	}
-
-	return iselected;
+	return itemSelect[LIST];
 }
 
 
@@ -523,20 +868,37 @@ void SelectCb(Fl_Widget* w, UNUSED void* data)
 {
 	ASSERT_DBG(w);
 
-	Fl_Hold_Browser* b = (Fl_Hold_Browser*)w;
-
-	int iselected = GetSelected(b);
-
-	if (b == browser[ENABLE])
+	if (w == serviceTable)
 	{
-		itemSelect[ENABLE] = iselected;
-		FillBrowserEnable();
+		// A resource column was just shown.
+		if (serviceTable->ResourcesShown() && !procSampling)
+		{
+			SampleServices();
+			ShowServiceTable();
+		}
+
+		SetStatus_CommandButtons();
+		return;
 	}
-	else
+
+	int const iselected = GetSelected((Fl_Hold_Browser*)w);
+
+	itemSelect[LIST] = iselected;
+	SetStatus_LoadUnloadButtons(iselected);
+}
+
+
+void FilterCb(Fl_Widget* w, UNUSED void* data)
+{
+	if (w == filterServices)
 	{
-		itemSelect[LIST] = iselected;
-		FillBrowserList();
+		ShowServiceTable();
+		return;
 	}
+
+	// The best match is selected.
+	itemSelect[LIST] = SELECT_RESET;
+	ShowBrowserList();
 }
 
 
@@ -545,31 +907,51 @@ bool AskIfContinue(char const* const service)
 	ASSERT_DBG(service);
 	ASSERT_DBG(service[0] != '\0');
 
-	char* str = strdup(ASK_SERVICES);
+	std::vector<std::string> const services(1, service);
+
+	return AskIfContinue(services);
+}
 
-	ASSERT_DBG(str);
 
-	char* tok = strtok(str, ASK_SERVICES_DELIM);
+/* A single question with all the protected services. */
+bool AskIfContinue(std::vector<std::string> const& services)
+{
+	ASSERT_DBG(services.size() > 0);
 
-	ASSERT_DBG(tok);
+	std::string found;
 
-	do
+	for (std::string const& service : services)
 	{
-		if (strstr(service, tok))
-		{
-			MESSAGE_DBG("ASK_SERVICES: %s", tok);
+		char* str = strdup(ASK_SERVICES);
+
+		ASSERT_DBG(str);
+
+		char* tok = strtok(str, ASK_SERVICES_DELIM);
 
-			if (0 == fl_choice("Warning: Protected service name detected: %s\n"
-							"Do you continue?", "Cancel", "Continue", 0, service))
+		ASSERT_DBG(tok);
+
+		do
+		{
+			if (strstr(service.c_str(), tok))
 			{
-				free(str);
-				return false;
+				MESSAGE_DBG("ASK_SERVICES: %s", tok);
+
+				found += found.empty() ? "" : ", ";
+				found += service;
+				break;
 			}
-		}
-	} while ((tok = strtok(0, ASK_SERVICES_DELIM)));
+		} while ((tok = strtok(0, ASK_SERVICES_DELIM)));
 
-	free(str);
-	return true;
+		free(str);
+	}
+
+	if (found.empty())
+	{
+		return true;
+	}
+
+	return 0 != fl_choice("Warning: Protected service name detected: %s\n"
+						"Do you continue?", "Cancel", "Continue", 0, found.c_str());
 }
 
 
@@ -595,11 +977,16 @@ char* ExtractServiceNameFromSV(char const* const service)
 	if (e == NULL)
 	{
 	/* los servicios LOG no son en crudo sino que son creados en
-	 * runtime:
+	 * runtime: solo se quita '/log' del final, las rutas de los
+	 * otros SVRUNDIR no lo tienen.
 	 * */
-		e = strrchr(b, '/');
-		e -= 4; // '/log'
-		ASSERT_DBG(e != b);
+		b = name;
+		e = name + strlen(name);
+
+		if (e - b > 4 && strcmp(e - 4, "/log") == 0)
+		{
+			e -= 4;
+		}
 	}
 
 	std::ptrdiff_t const len = e - b;
@@ -622,34 +1009,332 @@ char* ExtractServiceNameFromPath(char const* const service)
 }
 
 
-void CommandSrvCb(Fl_Widget* w, UNUSED void* data)
+static void GetSelectedServices(std::vector<std::string>& services)
 {
-	Fl_Button const* const btnId = (Fl_Button*)w;
+	serviceTable->Selected(services);
+}
 
-	ASSERT_DBG(btnId != NULL);
 
-	char const* itemText = browser[ENABLE]->text(itemSelect[ENABLE]);
+/* SYS_LOG_DIR only has the logs of the first run directory, the others are named by their path. */
+static void GetSelectedLogServices(std::vector<std::string>& services)
+{
+	GetSelectedServices(services);
+
+	std::string skipped;
 
-	char* service = ExtractServiceNameFromPath(itemText);
+	auto const other = [&skipped](std::string const& service)
+	{
+		if (service[0] != '/')
+		{
+			return false;
+		}
 
-	MESSAGE_DBG("CommandSrvCb: service: %s", service);
+		skipped += "\n" + service;
+		return true;
+	};
 
-	Command(btnId, service);
+	services.erase(std::remove_if(services.begin(), services.end(), other), services.end());
 
-	free(service);
+	if (!skipped.empty())
+	{
+		fl_alert("Only the services of %s have their logs in %s, skipped:%s",
+				SV_RUN_DIR_SELECT, SYS_LOG_DIR, skipped.c_str());
+	}
 }
 
-void CommandLogCb(Fl_Widget* w, void* data)
+
+/* svlogd writes into SYS_LOG_DIR/service */
+void LogViewCb(UNUSED Fl_Widget* w, UNUSED void* data)
 {
-	Fl_Button const* const btnId = (Fl_Button*)w;
+	bool const showError = true;
 
-	ASSERT_DBG(btnId != NULL);
+	std::vector<std::string> services;
 
-	struct NewEditData* saveNewEditData = (struct NewEditData*)data;
+	GetSelectedLogServices(services);
 
-	ASSERT_DBG(saveNewEditData->input != NULL);
+	for (std::string const& service : services)
+	{
+		std::string dir;
 
-	char const* const service = saveNewEditData->input->value();
+		MakeSysLogDirPath(service, dir);
+
+		if (DirAccessOk(dir.c_str(), showError))
+		{
+			LogViewShow(dir.c_str(), service.c_str(), LOG_VIEW_FOLLOW);
+		}
+	}
+}
+
+
+void ProcTreeCb(UNUSED Fl_Widget* w, UNUSED void* data)
+{
+	char const* const current = serviceTable->Current();
+
+	if (current != NULL)
+	{
+		ProcTreeShow(current);
+	}
+}
+
+
+static void DepsTimerCb(UNUSED void* data)
+{
+	int const state = DepsStep(depsRun);
+
+	if (!depsRun.message.empty())
+	{
+		lblStatus->copy_label(depsRun.message.c_str());
+		FillServiceTable();
+	}
+
+	if (state == DEPS_RUNNING)
+	{
+		Fl::repeat_timeout(DEPS_POLL, DepsTimerCb);
+		return;
+	}
+
+	depsActive = false;
+
+	FillServiceTable();
+
+	if (state == DEPS_DONE)
+	{
+		std::string const str = std::string(depsRun.up ? "Started" : "Stopped") + " in "
+			+ std::to_string(depsRun.waves.size()) + " waves";
+
+		lblStatus->copy_label(str.c_str());
+		return;
+	}
+
+	std::string failed;
+
+	for (std::string const& name : depsRun.failed)
+	{
+		failed += "\n" + name;
+	}
+
+	fl_alert("%s stopped at wave %d of %d:%s", depsRun.up ? "Start" : "Stop",
+			(int)depsRun.wave + 1, (int)depsRun.waves.size(), failed.c_str());
+}
+
+
+/* In waves by the 'deps' files, see deps.h. */
+void DepsCb(UNUSED Fl_Widget* w, void* data)
+{
+	bool const up = (strcmp((char const*)data, "start") == 0);
+
+	if (depsActive)
+	{
+		fl_alert("Wait until the previous start or stop ends.");
+		return;
+	}
+
+	std::vector<std::string> services;
+
+	GetSelectedServices(services);
+
+	if (services.empty())
+	{
+		return;
+	}
+
+	std::vector<std::vector<std::string> > waves;
+	std::string error;
+
+	if (!DepsWaves(SV_DIR_SELECT, SV_RUN_DIR_SELECT, services, up, waves, error))
+	{
+		fl_alert("%s", error.c_str());
+		return;
+	}
+
+	// Stopping also takes the services that need them.
+	if (!up)
+	{
+		std::string list;
+
+		for (size_t i = 0; i < waves.size(); ++i)
+		{
+			list += "\n" + std::to_string(i + 1) + ":";
+
+			for (std::string const& name : waves[i])
+			{
+				list += " " + name;
+			}
+		}
+
+		if (!fl_choice("These services will be stopped, in this order:\n%s", "No",
+					"Yes, stop them", 0, list.c_str()))
+		{
+			return;
+		}
+	}
+
+	if (!DepsStart(depsRun, SV_DIR_SELECT, SV_RUN_DIR_SELECT, services, up, DEPS_TIMEOUT, error))
+	{
+		fl_alert("%s", error.c_str());
+		return;
+	}
+
+	depsActive = true;
+
+	lblStatus->copy_label(depsRun.message.c_str());
+
+	Fl::add_timeout(DEPS_POLL, DepsTimerCb);
+}
+
+
+static bool logMerging = false;
+
+
+/* Between chunks of lines the window keeps answering. */
+static void LogMergeStepCb(LogMergeResult const& result, UNUSED void* data)
+{
+	std::string const str = "Merging logs: " + std::to_string(result.lines) + " lines";
+
+	lblStatus->copy_label(str.c_str());
+	Fl::check();
+}
+
+
+/* One timeline of the logs of the selected services, saved in a file. */
+void LogMergeCb(UNUSED Fl_Widget* w, UNUSED void* data)
+{
+	bool const showError = true;
+
+	if (logMerging)
+	{
+		fl_alert("Wait until the previous merge ends.");
+		return;
+	}
+
+	std::vector<std::string> services;
+
+	GetSelectedLogServices(services);
+
+	std::vector<LogMergeInput> inputs;
+
+	for (std::string const& service : services)
+	{
+		LogMergeInput input;
+
+		input.name = service;
+		MakeSysLogDirPath(service, input.dir);
+
+		if (DirAccessOk(input.dir.c_str(), showError))
+		{
+			inputs.push_back(input);
+		}
+	}
+
+	if (inputs.size() < 2)
+	{
+		fl_alert("Select two or more services with logs to merge them.");
+		return;
+	}
+
+	char const* const chooser = fl_file_chooser("Save the merged log", "*", LOG_MERGE_FILE);
+
+	if (chooser == NULL)
+	{
+		return;
+	}
+
+	std::string const path = chooser;
+
+	errno = 0;
+
+	FILE* out = fopen(path.c_str(), "w");
+
+	if (out == NULL)
+	{
+		fl_alert("The file '%s' could not be created.\nError:%s", path.c_str(), strerror(errno));
+		return;
+	}
+
+	fl_cursor(FL_CURSOR_WAIT);
+	Fl::check();
+
+	logMerging = true;
+
+	LogMergeResult result;
+
+	bool ok = LogMerge(inputs, out, result, LogMergeStepCb, NULL);
+
+	ok = (fclose(out) == 0) && ok;
+
+	logMerging = false;
+
+	fl_cursor(FL_CURSOR_DEFAULT);
+	ShowSvJobs();
+
+	if (!ok)
+	{
+		fl_alert("Failed to write the merged log: %s\nError:%s", path.c_str(), strerror(errno));
+		return;
+	}
+
+	if (fl_choice("%zu lines merged into:\n%s", "Close", "Open", 0, result.lines, path.c_str()) == 1)
+	{
+		LogViewShow(path.c_str(), "merged", 0);
+	}
+}
+
+
+void CommandSrvCb(Fl_Widget* w, UNUSED void* data)
+{
+	Fl_Button const* const btnId = (Fl_Button*)w;
+
+	ASSERT_DBG(btnId != NULL);
+
+	std::vector<std::string> services;
+
+	GetSelectedServices(services);
+
+	MESSAGE_DBG("CommandSrvCb: services: %zu", services.size());
+
+	if (services.empty())
+	{
+		return;
+	}
+
+	Command(btnId, services);
+}
+
+/* The signals of runsv(8) that have no button. */
+void SignalSrvCb(UNUSED Fl_Widget* w, void* data)
+{
+	char const* const action = (char const*)data;
+
+	ASSERT_DBG_STRING(action);
+
+	std::vector<std::string> services;
+
+	GetSelectedServices(services);
+
+	if (services.empty())
+	{
+		return;
+	}
+
+	if (AskIfContinue(services))
+	{
+		MESSAGE_DBG("SIGNAL %s service: %s", action, services[0].c_str());
+		RunSv(services, action, NOTIFY_SIGNAL);
+	}
+}
+
+
+void CommandLogCb(Fl_Widget* w, void* data)
+{
+	Fl_Button const* const btnId = (Fl_Button*)w;
+
+	ASSERT_DBG(btnId != NULL);
+
+	struct NewEditData* saveNewEditData = (struct NewEditData*)data;
+
+	ASSERT_DBG(saveNewEditData->input != NULL);
+
+	char const* const service = saveNewEditData->input->value();
 
 	ASSERT_DBG(service != NULL);
 
@@ -659,136 +1344,640 @@ void CommandLogCb(Fl_Widget* w, void* data)
 
 	MESSAGE_DBG("CommandLogCb: service: %s, path: %s", service, path.c_str());
 
-	Command(btnId, path.c_str());
+	std::vector<std::string> const services(1, path);
+
+	Command(btnId, services);
 }
 
 
-void Command(Fl_Button const* const btnId, char const* const service)
+void Command(Fl_Button const* const btnId, std::vector<std::string> const& services)
 {
+	ASSERT_DBG(services.size() > 0);
+
 	if (btnId == btn[RUN] || btnId == btn[RUN_LOG])
 	{
-		MESSAGE_DBG("UP service: %s", service);
-		RunSv(service, "up");
-		ShowNotify(NOTIFY_UP, service);
+		MESSAGE_DBG("UP service: %s", services[0].c_str());
+		RunSv(services, "up", NOTIFY_UP);
 	}
 	else if (btnId == btn[RESTART] || btnId == btn[RESTART_LOG])
 	{
-		if (AskIfContinue(service))
+		if (AskIfContinue(services))
 		{
-			MESSAGE_DBG("RESTART service: %s", service);
-			RunSv(service, "restart");
-			ShowNotify(NOTIFY_RESTART, service);
+			MESSAGE_DBG("RESTART service: %s", services[0].c_str());
+			RunSv(services, "restart", NOTIFY_RESTART);
 		}
 	}
 	else if (btnId == btn[DOWN] || btnId == btn[DOWN_LOG])
 	{
-		if (AskIfContinue(service))
+		if (AskIfContinue(services))
 		{
-			MESSAGE_DBG("DOWN service: %s", service);
-			RunSv(service, "down");
-			ShowNotify(NOTIFY_DOWN, service);
+			MESSAGE_DBG("DOWN service: %s", services[0].c_str());
+			RunSv(services, "down", NOTIFY_DOWN);
 		}
 	}
 	else if (btnId == btn[KILL] || btnId == btn[KILL_LOG])
 	{
-		if (AskIfContinue(service))
+		if (AskIfContinue(services))
 		{
-			MESSAGE_DBG("KILL service: %s", service);
-			RunSv(service, "kill");
-			ShowNotify(NOTIFY_KILL, service);
+			MESSAGE_DBG("KILL service: %s", services[0].c_str());
+			RunSv(services, "kill", NOTIFY_KILL);
 		}
 	}
 	else if (btnId == btn[ALARM_LOG])
 	{
-		MESSAGE_DBG("ALARM service: %s", service);
-		RunSv(service, "alarm");
-		ShowNotify(NOTIFY_ALARM, service);
+		MESSAGE_DBG("ALARM service: %s", services[0].c_str());
+		RunSv(services, "alarm", NOTIFY_ALARM);
+	}
+	else
+	{
+		STOP_DBG("Button identifier not covered: %p", btnId);
+	}
+
+}
+
+
+void RemoveNewLine(std::string& str)
+{
+	size_t const pos = str.find('\n');
+
+	if (pos != std::string::npos)
+	{
+		str.erase(pos);
+	}
+}
+
+
+void LoadUnloadCb(Fl_Widget* w, UNUSED void* data)
+{
+	ASSERT_DBG(w);
+
+	Fl_Button* btnId = (Fl_Button*)w;
+
+	int const item = GetSelected(browser[LIST]);
+	char const* const service = browser[LIST]->text(item);
+
+	ASSERT_DBG_STRING(service);
+
+	if (btnId == btn[UNLOAD])
+	{
+		if (not AskIfContinue(service))
+		{
+			return;
+		}
+	}
+
+	std::string dest;
+	MakeServiceRunDirPath(service, dest);
+	RemoveNewLine(dest);
+
+	size_t const id = RegistryFind(service);
+
+	ASSERT_DBG(id != REGISTRY_NONE);
+
+	Service& srv = RegistryAt(id);
+
+	if (btnId == btn[LOAD])
+	{
+		std::string src;
+		MakeServicePath(service, src);
+		RemoveNewLine(src);
+		srv.linked = Link(src.c_str(), dest.c_str());
+		ShowNotify(NOTIFY_UP, service);
+	}
+	else if (btnId == btn[UNLOAD])
+	{
+		srv.linked = !Unlink(dest.c_str());
+		ShowNotify(NOTIFY_DOWN, service);
+	}
+	else
+	{
+		STOP_DBG("Button identifier not covered: %p", btnId);
+	}
+
+	BrowserListIcon(srv);
+	SetStatus_LoadUnloadButtons(srv.linked);
+
+	FillServiceTable();
+}
+
+
+/*
+ * One sv command per service of the batch. With SV_EXEC at most
+ * BATCH_JOBS commands run at once, the rest wait in svQueue; the
+ * control fifo and xrunitd take them all without waiting.
+ */
+struct SvBatch
+{
+	std::string action;
+	std::string done;   /* base names, for ShowNotify */
+	std::string failed;
+	int notifyId;
+	int remaining;
+	double perfStart;
+};
+
+struct SvJob
+{
+	std::string service;
+	SvBatch* batch;
+	int id;              /* of the command sent to xrunitd */
+};
+
+static std::vector<SvJob*> svJobs;
+static std::deque<SvJob*> svQueue;
+
+static void StartSvJobs(void);
+
+
+/* The status bar shows the sv jobs, otherwise the timings if enabled. */
+static void ShowPerf(void)
+{
+	if (!svJobs.empty())
+	{
+		return;
+	}
+
+	if (!perfEnabled)
+	{
+		lblStatus->copy_label("");
+		return;
+	}
+
+	std::string str;
+
+	PerfFormat(str);
+
+	lblStatus->copy_label(str.c_str());
+}
+
+
+static void ShowSvJobs(void)
+{
+	if (svJobs.empty())
+	{
+		ShowPerf();
+		return;
+	}
+
+	std::string str = "Running:";
+
+	for (SvJob const* job : svJobs)
+	{
+		str += " sv ";
+		str += job->batch->action;
+		str += " ";
+		str += job->service;
+		str += ";";
+	}
+
+	if (!svQueue.empty())
+	{
+		str += " waiting: ";
+		str += std::to_string(svQueue.size());
+	}
+
+	lblStatus->copy_label(str.c_str());
+}
+
+
+static void RunSvBatchDone(SvBatch* batch)
+{
+	PERF_END(PERF_COMMAND, batch->perfStart);
+
+	if (!batch->failed.empty())
+	{
+		fl_alert("The command was executed but ended with error.\n"
+				"%s: %s", batch->action.c_str(), batch->failed.c_str());
+	}
+
+	if (!batch->done.empty())
+	{
+		ShowNotify(batch->notifyId, batch->done.c_str());
+	}
+
+	delete batch;
+
+	FillServiceTable();
+}
+
+
+static void SvJobDone(SvJob* job, char const* const error)
+{
+	ASSERT_DBG(job);
+
+	SvBatch* batch = job->batch;
+
+	MESSAGE_DBG("%s %s: %s", batch->action.c_str(), job->service.c_str(), error ? error : "ok");
+
+	std::string& list = error ? batch->failed : batch->done;
+
+	list += list.empty() ? "" : ", ";
+
+	// The services of the other roots and the logs are paths.
+	if (!error && job->service[0] == '/')
+	{
+		char* const name = ExtractServiceNameFromPath(job->service.c_str());
+		list += name;
+		free(name);
+	}
+	else
+	{
+		list += job->service;
+	}
+
+	if (error)
+	{
+		list += " (";
+		list += error;
+		list += ")";
+	}
+
+	delete job;
+
+	if (--batch->remaining == 0)
+	{
+		RunSvBatchDone(batch);
+	}
+}
+
+#ifdef SV_EXEC
+static void RunSvDoneCb(int const status, void* data)
+{
+	SvJob* job = (SvJob*)data;
+
+	ASSERT_DBG(job);
+
+	for (size_t i = 0; i < svJobs.size(); ++i)
+	{
+		if (svJobs[i] == job)
+		{
+			svJobs.erase(svJobs.begin() + i);
+			break;
+		}
+	}
+
+	bool const ok = WIFEXITED(status) && WEXITSTATUS(status) == 0;
+
+	SvJobDone(job, ok ? NULL : "sv failed");
+
+	StartSvJobs();
+	ShowSvJobs();
+}
+
+
+static void StartSvJobs(void)
+{
+	while (!svQueue.empty() && svJobs.size() < BATCH_JOBS)
+	{
+		SvJob* job = svQueue.front();
+		svQueue.pop_front();
+
+		char* argv[4];
+		argv[0] = (char*)SV;
+		argv[1] = (char*)job->batch->action.c_str();
+		argv[2] = (char*)job->service.c_str();
+		argv[3] = (char*)NULL;
+
+		svJobs.push_back(job);
+
+		if (!ExecAsync(SV, argv, RunSvDoneCb, (void*)job))
+		{
+			RunSvDoneCb(W_EXITCODE(127, 0), (void*)job);
+		}
+	}
+}
+#else
+/* Without fork: one write into the supervise/control fifo. */
+static void StartSvJobs(void)
+{
+	while (!svQueue.empty())
+	{
+		SvJob* job = svQueue.front();
+		svQueue.pop_front();
+
+		char const* const cmd = ControlCommand(job->batch->action.c_str());
+
+		ASSERT_DBG(cmd);
+
+		std::string dir;
+
+		if (job->service[0] == '/')
+		{
+			dir = job->service;
+		}
+		else
+		{
+			MakeServiceRunDirPath(job->service, dir);
+		}
+
+		int const error = ControlSend(dir.c_str(), cmd);
+
+		SvJobDone(job, error ? ControlError(error) : NULL);
+	}
+}
+#endif
+
+
+/* 'name' of SV_RUN_DIR, or 'name/log' from the log path of the service. */
+static void DaemonServiceName(std::string const& service, std::string& name)
+{
+	if (service[0] != '/')
+	{
+		name = service;
+		return;
+	}
+
+	name = service;
+
+	while (name.size() > 1 && name.back() == '/')
+	{
+		name.pop_back();
+	}
+
+	bool const log = (name.size() > 4 && name.compare(name.size() - 4, 4, "/log") == 0);
+
+	if (log)
+	{
+		name.erase(name.size() - 4);
+	}
+
+	name.erase(0, name.rfind('/') + 1);
+	name += log ? "/log" : "";
+}
+
+
+/* xrunitd queues them, the answers arrive through ClientCb. */
+static void StartDaemonJobs(void)
+{
+	static int lastId = 0;
+
+	while (!svQueue.empty())
+	{
+		SvJob* job = svQueue.front();
+		svQueue.pop_front();
+
+		std::string name;
+
+		DaemonServiceName(job->service, name);
+
+		job->id = ++lastId;
+
+		if (ClientSend(clientFd, job->id, job->batch->action.c_str(), name.c_str()))
+		{
+			svJobs.push_back(job);
+		}
+		else
+		{
+			SvJobDone(job, strerror(errno));
+		}
+	}
+}
+
+
+void RunSv(std::vector<std::string> const& services, char const* const action, int const notifyId)
+{
+	ASSERT_DBG_STRING(action);
+
+	// No batch, it would never end.
+	if (services.empty())
+	{
+		return;
+	}
+
+	SvBatch* batch = new SvBatch;
+	batch->action = action;
+	batch->notifyId = notifyId;
+	batch->remaining = services.size();
+	batch->perfStart = perfEnabled ? PerfNow() : 0.0;
+
+	for (std::string const& service : services)
+	{
+		ASSERT_DBG_STRING(service.c_str());
+
+		SvJob* job = new SvJob;
+		job->service = service;
+		job->batch = batch;
+		job->id = 0;
+		svQueue.push_back(job);
+	}
+
+	if (clientFd != -1)
+	{
+		StartDaemonJobs();
+	}
+	else
+	{
+		StartSvJobs();
+	}
+
+	ShowSvJobs();
+}
+
+
+void TimerCb(UNUSED void* data)
+{
+	FillServiceTable();
+	Fl::repeat_timeout((watchFd != -1) ? TIME_SAFETY : TIME_UPDATE, TimerCb);
+}
+
+
+/* runsv only writes its status on a change: the rows again with a new 'now', without a scan. */
+void UptimeTimerCb(UNUSED void* data)
+{
+	ShowServiceTable();
+	Fl::repeat_timeout(TIME_UPDATE, UptimeTimerCb);
+}
+
+
+/* Only the service process while it runs, not runsv nor ./finish. */
+static void SampleServices(void)
+{
+	PERF_BEGIN(procStart);
+
+	std::vector<ProcJob> jobs;
+	jobs.reserve(RegistrySize());
+
+	for (size_t id = 0; id < RegistrySize(); ++id)
+	{
+		Service& srv = RegistryAt(id);
+
+		pid_t const pid = (srv.state == STATE_RUN) ? srv.pid : 0;
+
+		if (pid != 0 || srv.proc.pid != 0)
+		{
+			jobs.push_back({ &srv.proc, pid });
+		}
+	}
+
+	ProcSampleAll(jobs);
+
+	// One pass over /proc for all the services.
+	if (serviceTable->TreeShown())
+	{
+		ProcTreeUpdate(0);
+	}
+
+	procSampling = true;
+
+	PERF_END(PERF_PROC, procStart);
+}
+
+
+void ProcTimerCb(UNUSED void* data)
+{
+	if (serviceTable->ResourcesShown())
+	{
+		SampleServices();
+		ShowServiceTable();
+	}
+	else if (procSampling)
+	{
+		// Hidden columns, the cached descriptors are closed.
+		for (size_t id = 0; id < RegistrySize(); ++id)
+		{
+			ProcStatClose(RegistryAt(id).proc);
+		}
+
+		procSampling = false;
+		ShowServiceTable();
+	}
+
+	Fl::repeat_timeout(TIME_PROC, ProcTimerCb);
+}
+
+
+static void WatchServices(void)
+{
+	WatchReset();
+
+	for (size_t i = 0; i < statusSnapshot.size(); ++i)
+	{
+		WatchAdd(statusSnapshot[i].path.c_str(), i);
+	}
+}
+
+
+static void WatchCb(UNUSED int fd, UNUSED void* data)
+{
+	std::vector<size_t> changed;
+
+	if (WatchRead(changed))
+	{
+		FillServiceTable();
+		return;
+	}
+
+	if (changed.empty())
+	{
+		return;
 	}
-	else
+
+	for (size_t const id : changed)
 	{
-		STOP_DBG("Button identifier not covered: %p", btnId);
+		ASSERT_DBG(id < statusSnapshot.size());
+		StatusReadService(&statusSnapshot[id]);
+		RegistrySetStatus(statusSnapshot[id]);
 	}
 
+	ShowServiceTable();
 }
 
 
-void RemoveNewLine(std::string& str)
+static void WatchStart(void)
 {
-	size_t const pos = str.find('\n');
+	watchFd = WatchOpen(SV_RUN_DIR_SELECT);
 
-	if (pos != std::string::npos)
+	if (watchFd == -1)
 	{
-		str.erase(pos);
+		WARNING("inotify is not available, polling every %d seconds.", TIME_UPDATE);
+		return;
 	}
-}
 
+	for (size_t root = 1; root < runRoots.size(); ++root)
+	{
+		WatchAddRoot(runRoots[root].c_str());
+	}
 
-void LoadUnloadCb(Fl_Widget* w, UNUSED void* data)
-{
-	ASSERT_DBG(w);
+	WatchServices();
 
-	Fl_Button* btnId = (Fl_Button*)w;
+	Fl::add_fd(watchFd, FL_READ, WatchCb);
+}
 
-	int const item = GetSelected(browser[LIST]);
-	char const* const service = browser[LIST]->text(item);
 
-	ASSERT_DBG_STRING(service);
+static void ClientCb(UNUSED int fd, UNUSED void* data)
+{
+	if (!ClientRead(clientFd, clientState, statusSnapshot))
+	{
+		fl_alert("The connection with xrunitd was closed: %s", XRUNITD_SOCKET_SELECT);
+		exit(EXIT_FAILURE);
+	}
 
-	if (btnId == btn[UNLOAD])
+	for (ClientReply const& reply : clientState.replies)
 	{
-		if (not AskIfContinue(service))
+		for (size_t i = 0; i < svJobs.size(); ++i)
 		{
-			return;
+			SvJob* job = svJobs[i];
+
+			if (job->id == reply.id)
+			{
+				svJobs.erase(svJobs.begin() + i);
+				SvJobDone(job, reply.error ? ControlError(reply.error) : NULL);
+				break;
+			}
 		}
 	}
 
-	std::string dest;
-	MakeServiceRunDirPath(service, dest);
-	RemoveNewLine(dest);
+	clientState.replies.clear();
 
-	if (btnId == btn[LOAD])
+	if (clientState.batches == 0)
 	{
-		std::string src;
-		MakeServicePath(service, src);
-		RemoveNewLine(src);
-		Link(src.c_str(), dest.c_str());
-		ShowNotify(NOTIFY_UP, service);
+		ShowSvJobs();
+		return;
 	}
-	else if (btnId == btn[UNLOAD])
+
+	// Like WatchCb, the whole list only when services came or went.
+	if (clientState.reset)
 	{
-		Unlink(dest.c_str());
-		ShowNotify(NOTIFY_DOWN, service);
+		FillServiceTable();
 	}
-	else
+	else if (!clientState.changed.empty())
 	{
-		STOP_DBG("Button identifier not covered: %p", btnId);
+		for (size_t const id : clientState.changed)
+		{
+			ASSERT_DBG(id < statusSnapshot.size());
+			RegistrySetStatus(statusSnapshot[id]);
+		}
+
+		ShowServiceTable();
 	}
 
-	FillBrowserEnable();
-	FillBrowserList();
+	clientState.changed.clear();
+	clientState.reset = false;
+	clientState.batches = 0;
+
+	ShowSvJobs();
 }
 
 
-void RunSv(char const* const service, char const* const action)
+/* The first batch is the snapshot, before the window is filled. */
+static void ClientStart(char const* const socketPath)
 {
-	ASSERT_DBG_STRING(service);
-	ASSERT_DBG_STRING(action);
+	clientState.reset = false;
+	clientState.batches = 0;
 
-	char* argv[4];
-	argv[0] = (char*)SV;
-	argv[1] = (char*)action;
-	argv[2] = (char*)service;
-	argv[3] = (char*)NULL;
+	clientFd = ClientConnect(socketPath);
 
-	System(SV, argv);
-	FillBrowserEnable();
-}
+	if (clientFd == -1 || !ClientWait(clientFd, clientState, statusSnapshot, 0))
+	{
+		fl_alert("Failed to connect with xrunitd: %s\nError:%s", socketPath, strerror(errno));
+		exit(EXIT_FAILURE);
+	}
 
+	clientState.changed.clear();
+	clientState.reset = false;
+	clientState.batches = 0;
 
-void TimerCb(UNUSED void* data)
-{
-	FillBrowserEnable();
-	Fl::repeat_timeout(TIME_UPDATE, TimerCb);
+	Fl::add_fd(clientFd, FL_READ, ClientCb);
 }
 
 
@@ -839,7 +2028,8 @@ void AddServicesCb(UNUSED Fl_Widget* w, void* data)
 	btn[UNLOAD] = new Fl_Button(BTN_W * 2 + BTN_PAD, BTN_Y, BTN_W, BTN_H, STR_UNLOAD);
 	btn[EDIT] = new Fl_Button(BTN_W * 3 + BTN_PAD, BTN_Y, BTN_W, BTN_H, STR_EDIT);
 	btn[NEW] = new Fl_Button(BTN_W * 4 + BTN_PAD, BTN_Y, BTN_W, BTN_H, STR_NEW);
-	browser[LIST] = new Fl_Hold_Browser(4, 40, wnd->w() - 8, wnd->h() - 48);
+	filterList = new Fl_Input(4 + FILTER_LBL_W, 40, wnd->w() - 8 - FILTER_LBL_W, FILTER_H, "Filter:");
+	browser[LIST] = new Fl_Hold_Browser(4, 44 + FILTER_H, wnd->w() - 8, wnd->h() - 52 - FILTER_H);
 
 	btn[CLOSE]->image(get_icon_quit());
 	btn[LOAD]->image(get_icon_add());
@@ -848,6 +2038,8 @@ void AddServicesCb(UNUSED Fl_Widget* w, void* data)
 	btn[NEW]->image(get_icon_new());
 
 	browser[LIST]->callback(SelectCb);
+	filterList->when(FL_WHEN_CHANGED);
+	filterList->callback(FilterCb);
 	btn[CLOSE]->callback(CloseWindowCb, (void*)wnd);
 	btn[LOAD]->callback(LoadUnloadCb);
 	btn[UNLOAD]->callback(LoadUnloadCb);
@@ -855,11 +2047,14 @@ void AddServicesCb(UNUSED Fl_Widget* w, void* data)
 	btn[NEW]->callback(EditNewCb, (void*)wnd);
 
 	SetFont(browser[LIST]);
+	SetFont(filterList);
+	filterList->textfont(FONT);
+	filterList->textsize(FONT_SZ);
 	SetButtonFont(CLOSE, NEW, btn);
 	SetButtonAlign(CLOSE, NEW, 256, btn);
 
 	FillBrowserList();
-	BrowserListSelection_EqualToBrowserEnable();
+	BrowserListSelection_EqualToServiceTable();
 
 	ShowWindowModal(wnd);
 
@@ -869,13 +2064,15 @@ void AddServicesCb(UNUSED Fl_Widget* w, void* data)
 	}
 
 	delete browser[LIST];
+	delete filterList;
+	filterList = NULL;
 	delete wnd;
 }
 
 
 void MakeServiceRunDirPath(std::string const& service, std::string& path)
 {
-	path = SV_RUN_DIR;
+	path = SV_RUN_DIR_SELECT;
 	path += "/";
 	path += service;
 }
@@ -963,50 +2160,26 @@ static void MakeLogConfPath(std::string const& service, std::string& path)
 }
 
 
-static unsigned long CalculateHash(Fl_Text_Buffer const* const txtBuff)
-{
-	char* text = txtBuff->text();
-
-	if (text == (char*)NULL)
-	{
-		return 0UL;
-	}
-
-	if (text[0] == '\0')
-	{
-		free(text);
-		return 0UL;
-	}
-
-	unsigned long hash = Hash(text);
-	free(text);
-	return hash;
-}
-
-
-static bool IfNotEqualHash(Fl_Text_Buffer const* const txtBuff, unsigned long const hash)
-{
-	unsigned long const txtBuffHash = CalculateHash(txtBuff);
-	return (txtBuffHash != hash);
-}
-
-
-static void AskAndDeleteFile(std::string const& path)
+static bool AskAndDeleteFile(std::string const& path)
 {
-	if( fl_choice("Question about deleting file.\nThe file exists but is empty.\n\n"
-				"Do you want to delete it?\n"
+	if( fl_choice("Question about deleting file.\nThe file was emptied.\n\n"
+				"Do you want to delete it? Otherwise it is saved empty.\n"
 				"File:'%s'", "No", "Yes, delete", 0, path.c_str()))
 	{
 		MESSAGE_DBG("DELETE FILE:%s", path.c_str());
 		Unlink(path.c_str());
+		return true;
 	}
+
+	return false;
 }
 
 
 static bool AskAndDeleteDir(std::string const& dir, std::string const& path)
 {
-	if( fl_choice("Question about deleting directory.\nThe file '%s' is empty.'\n\n"
+	if( fl_choice("Question about deleting directory.\nThe file '%s' was emptied.\n\n"
 				"Do you want to delete the directory with all its contents?\n"
+				"Otherwise the file is saved empty.\n"
 				"Dir:'%s'", "No", "Yes, delete all", 0, path.c_str(), dir.c_str()))
 	{
 		MESSAGE_DBG("DELETE RECURSIVE:%s", dir.c_str());
@@ -1018,52 +2191,117 @@ static bool AskAndDeleteDir(std::string const& dir, std::string const& path)
 }
 
 
-static bool IsEmptyTextBuffer(Fl_Text_Buffer* tb)
+static bool IsRunELF(Fl_Text_Buffer* buf, Fl_Text_Editor* ed, char const* const path)
 {
-	ASSERT_DBG(tb);
+	bool const showError = true;
 
-	if (tb->length() == 0)
+	if (isFileTypeELF(path, not showError))
 	{
+		buf->text("ELF executable file detected.\n\n"
+					"We detect that the 'run' file is not a\ntext file"
+					" and therefore is not editable.\n\n"
+					"All 'Extra...' actions continue to work as normal.");
+		ed->deactivate();
 		return true;
 	}
+	return false;
+}
+
+/* The file edited in the tab of 'id', TBUF_*. */
+static void MakeEditPath(int const id, std::string const& service, std::string& path)
+{
+	switch (id)
+	{
+		case TBUF_SERV:
+			MakeServiceRunPath(service, path);
+			break;
+		case TBUF_LOG:
+			MakeLogRunPath(service, path);
+			break;
+		case TBUF_LOG_CONF:
+			MakeLogConfPath(service, path);
+			break;
+		case TBUF_FINISH:
+			MakeServiceFinishPath(service, path);
+			break;
+		case TBUF_CONF:
+			MakeServiceConfPath(service, path);
+			break;
+		case TBUF_CHECK:
+			MakeServiceCheckPath(service, path);
+			break;
+		default:
+			STOP_DBG("Text buffer not contemplated: %d", id);
+	}
+}
+
+
+/* Group of the tab of each TBUF_*, the innermost one for the log. */
+static int const editTabLabel[TBUF_MAX] = {
+	[TBUF_SERV] = LBL_SERV,
+	[TBUF_LOG] = LBL_LOG_RUN,
+	[TBUF_LOG_CONF] = LBL_LOG_CONF,
+	[TBUF_FINISH] = LBL_FINISH,
+	[TBUF_CONF] = LBL_CONF,
+	[TBUF_CHECK] = LBL_CHECK,
+};
+
 
-	for(int i = 0; i < tb->length(); ++i)
+/* TBUF_*, TEDT_* and LBL_TIME_* follow the same order. */
+static void EditLoadFile(struct NewEditData* saveNewEditData, int const id)
+{
+	ASSERT_DBG(id >= 0 && id < TBUF_MAX);
+
+	if (saveNewEditData->loaded[id])
 	{
-		char const c = tb->byte_at(i);
+		return;
+	}
 
-		if (c != ' ' && c != '\n')
-		{
-			return false;
-		}
+	saveNewEditData->loaded[id] = true;
+
+	std::string path;
+
+	MakeEditPath(id, saveNewEditData->input->value(), path);
+
+	bool const script = (id == TBUF_SERV || id == TBUF_LOG);
+
+	if (!script || not IsRunELF(tbuf[id], tedt[id], path.c_str()))
+	{
+		tbuf[id]->loadfile(path.c_str());
 	}
 
-	return true;
+	TextStateReset(tstate[id]);
+	saveNewEditData->time[id]->copy_label(GetModifyFileTime(path.c_str()));
 }
 
 
-static bool IsRunELF(Fl_Text_Buffer* buf, Fl_Text_Editor* ed, char const* const path)
+static void EditTabCb(UNUSED Fl_Widget* w, void* data)
 {
-	bool const showError = true;
+	struct NewEditData* saveNewEditData = (struct NewEditData*)data;
 
-	if (isFileTypeELF(path, not showError))
+	Fl_Widget* tab = saveNewEditData->tabs->value();
+
+	if (tab == saveNewEditData->label[LBL_LOG])
 	{
-		buf->text("ELF executable file detected.\n\n"
-					"We detect that the 'run' file is not a\ntext file"
-					" and therefore is not editable.\n\n"
-					"All 'Extra...' actions continue to work as normal.");
-		ed->deactivate();
-		return true;
+		tab = saveNewEditData->tabLog->value();
+	}
+
+	for (int id = 0; id < TBUF_MAX; ++id)
+	{
+		if (tab == saveNewEditData->label[editTabLabel[id]])
+		{
+			EditLoadFile(saveNewEditData, id);
+			return;
+		}
 	}
-	return false;
 }
 
+
+/* Only 'run' is read, the other tabs are colored by the size of their file. */
 static void EditLoad(struct NewEditData* saveNewEditData)
 {
 	bool const showError = true;
-	int const item = GetSelected(browser[LIST]);
-	std::string service = browser[LIST]->text(item);
-
-	RemoveNewLine(service);
+	std::string const service = saveNewEditData->input->value();
 
 	std::string path;
 
@@ -1074,92 +2312,79 @@ static void EditLoad(struct NewEditData* saveNewEditData)
 		fl_alert("The service '%s' exists but the 'run' file was not found.", service.c_str());
 	}
 
-	if (not IsRunELF(tbuf[TBUF_SERV], tedt[TEDT_SERV], path.c_str()))
+	EditLoadFile(saveNewEditData, TBUF_SERV);
+
+	for (int id = 0; id < TBUF_MAX; ++id)
 	{
-		tbuf[TBUF_SERV]->loadfile(path.c_str());
-	}
+		MakeEditPath(id, service, path);
 
-	saveNewEditData->hash[TBUF_SERV] = CalculateHash(tbuf[TBUF_SERV]);
-	saveNewEditData->time[LBL_TIME_SERV]->copy_label(GetModifyFileTime(path.c_str()));
+		struct stat st;
+
+		if (stat(path.c_str(), &st) != 0 || st.st_size == 0)
+		{
+			continue;
+		}
 
-	MakeLogRunPath(service, path);
+		saveNewEditData->label[editTabLabel[id]]->selection_color((Fl_Color)LBL_COLOR);
 
-	if (not IsRunELF(tbuf[TBUF_LOG], tedt[TEDT_LOG], path.c_str()))
-	{
-		tbuf[TBUF_LOG]->loadfile(path.c_str());
+		if (id == TBUF_LOG || id == TBUF_LOG_CONF)
+		{
+			saveNewEditData->label[LBL_LOG]->selection_color((Fl_Color)LBL_COLOR);
+		}
 	}
+}
 
-	saveNewEditData->hash[TBUF_LOG] = CalculateHash(tbuf[TBUF_LOG]);
-	saveNewEditData->time[LBL_TIME_LOG]->copy_label(GetModifyFileTime(path.c_str()));
 
-	MakeLogConfPath(service, path);
-	tbuf[TBUF_LOG_CONF]->loadfile(path.c_str());
-	saveNewEditData->hash[TBUF_LOG_CONF] = CalculateHash(tbuf[TBUF_LOG_CONF]);
-	saveNewEditData->time[LBL_TIME_LOG_CONF]->copy_label(GetModifyFileTime(path.c_str()));
+/* The text of the tab 'id' goes to the batch, nothing is written in place. */
+static void EditSaveAdd(SaveBatch& batch, unsigned int const id, std::string const& path,
+		bool const executable)
+{
+	char* const text = tbuf[id]->text();
 
-	MakeServiceFinishPath(service, path);
-	tbuf[TBUF_FINISH]->loadfile(path.c_str());
-	saveNewEditData->hash[TBUF_FINISH] = CalculateHash(tbuf[TBUF_FINISH]);
-	saveNewEditData->time[LBL_TIME_FINISH]->copy_label(GetModifyFileTime(path.c_str()));
+	SaveBatchAdd(batch, path, text, tbuf[id]->length(), executable);
 
-	MakeServiceConfPath(service, path);
-	tbuf[TBUF_CONF]->loadfile(path.c_str());
-	saveNewEditData->hash[TBUF_CONF] = CalculateHash(tbuf[TBUF_CONF]);
-	saveNewEditData->time[LBL_TIME_CONF]->copy_label(GetModifyFileTime(path.c_str()));
+	free(text);
+}
 
-	MakeServiceCheckPath(service, path);
-	tbuf[TBUF_CHECK]->loadfile(path.c_str());
-	saveNewEditData->hash[TBUF_CHECK] = CalculateHash(tbuf[TBUF_CHECK]);
-	saveNewEditData->time[LBL_TIME_CHECK]->copy_label(GetModifyFileTime(path.c_str()));
 
-	if (!IsEmptyTextBuffer(tbuf[TBUF_SERV]))
-	{
-		saveNewEditData->label[LBL_SERV]->selection_color((Fl_Color)LBL_COLOR);
-	}
+// A file of the edit window to write, or to delete when it was emptied.
+struct EditSaveFile
+{
+	unsigned int id;
+	std::string path;
+	bool executable;
+};
 
-	if (!IsEmptyTextBuffer(tbuf[TBUF_LOG]))
-	{
-		saveNewEditData->label[LBL_LOG]->selection_color((Fl_Color)LBL_COLOR);
-		saveNewEditData->label[LBL_LOG_RUN]->selection_color((Fl_Color)LBL_COLOR);
-	}
 
-	if (!IsEmptyTextBuffer(tbuf[TBUF_LOG_CONF]))
-	{
-		saveNewEditData->label[LBL_LOG]->selection_color((Fl_Color)LBL_COLOR);
-		saveNewEditData->label[LBL_LOG_CONF]->selection_color((Fl_Color)LBL_COLOR);
-	}
+static void NewEditSaveCb_Common(unsigned int const id, std::string const &path,
+								struct NewEditData* const saveNewEditData,
+								std::vector<EditSaveFile>& saves,
+								std::vector<EditSaveFile>& emptied)
+{
+	bool const showError = false;
 
-	if (!IsEmptyTextBuffer(tbuf[TBUF_FINISH]))
+	// Never shown, the file is as it was.
+	if (!saveNewEditData->loaded[id])
 	{
-		saveNewEditData->label[LBL_FINISH]->selection_color((Fl_Color)LBL_COLOR);
+		return;
 	}
 
-	if (!IsEmptyTextBuffer(tbuf[TBUF_CONF]))
+	if (!TextStateEmpty(tstate[id]) && TextStateDirty(tstate[id]))
 	{
-		saveNewEditData->label[LBL_CONF]->selection_color((Fl_Color)LBL_COLOR);
+		saves.push_back({id, path, true});
 	}
-
-	if (!IsEmptyTextBuffer(tbuf[TBUF_CHECK]))
+	else if (FileAccessOk(path.c_str(), showError) && TextStateEmpty(tstate[id]))
 	{
-		saveNewEditData->label[LBL_CHECK]->selection_color((Fl_Color)LBL_COLOR);
+		emptied.push_back({id, path, true});
 	}
 }
 
 
-static void NewEditSaveCb_Common(unsigned int const id, std::string const &path,
-								struct NewEditData* const saveNewEditData)
+static void AddDirToMake(std::vector<std::string>& dirs, std::string const& dir)
 {
-	bool const showError = false;
-
-	if (!IsEmptyTextBuffer(tbuf[id]) && IfNotEqualHash(tbuf[id], saveNewEditData->hash[id]))
-	{
-		tbuf[id]->savefile(path.c_str());
-		FileToExecutableMode(path.c_str());
-	}
-	else if (FileAccessOk(path.c_str(), showError) && IsEmptyTextBuffer(tbuf[id]))
+	if (std::find(dirs.begin(), dirs.end(), dir) == dirs.end())
 	{
-		tbuf[id]->savefile(path.c_str());
-		AskAndDeleteFile(path);
+		dirs.push_back(dir);
 	}
 }
 
@@ -1215,7 +2440,7 @@ static void NewEditSaveCb(UNUSED Fl_Widget* w, void* data)
 
 	int const id = saveNewEditData->id;
 
-	if (IsEmptyTextBuffer(tbuf[TBUF_SERV]))
+	if (TextStateEmpty(tstate[TBUF_SERV]))
 	{
 		if (NEW == id)
 		{
@@ -1233,7 +2458,10 @@ static void NewEditSaveCb(UNUSED Fl_Widget* w, void* data)
 	bool showError = true;
 	std::string path;
 	std::string dir;
-	bool recentlyDeletedLogDir = false;
+	std::string logDir;
+	std::vector<std::string> dirs;          // made only when the commit goes ahead
+	std::vector<EditSaveFile> saves;
+	std::vector<EditSaveFile> emptied;      // asked about once the rest is saved
 
 	switch (id)
 	{
@@ -1246,7 +2474,7 @@ static void NewEditSaveCb(UNUSED Fl_Widget* w, void* data)
 			return;
 		}
 
-		MakeDir(dir.c_str(), showError);
+		AddDirToMake(dirs, dir);
 
 		/* Fallthrough */
 
@@ -1254,17 +2482,19 @@ static void NewEditSaveCb(UNUSED Fl_Widget* w, void* data)
 
 		MakeServiceRunPath(service, path);
 
-		if (IfNotEqualHash(tbuf[TBUF_SERV], saveNewEditData->hash[TBUF_SERV]))
+		if (TextStateDirty(tstate[TBUF_SERV]))
 		{
-			MESSAGE_DBG("SAVE RUN, SERVICE: %s", service);
-			tbuf[TBUF_SERV]->savefile(path.c_str());
-			FileToExecutableMode(path.c_str());
+			saves.push_back({TBUF_SERV, path, true});
 		}
 
-		MakeLogDirPath(service, dir);
+		MakeLogDirPath(service, logDir);
+		MakeLogRunPath(service, path);
 
-		if (!IsEmptyTextBuffer(tbuf[TBUF_LOG]) && IfNotEqualHash(tbuf[TBUF_LOG],
-					saveNewEditData->hash[TBUF_LOG]))
+		if (!saveNewEditData->loaded[TBUF_LOG])
+		{
+			// Never shown, the file is as it was.
+		}
+		else if (!TextStateEmpty(tstate[TBUF_LOG]) && TextStateDirty(tstate[TBUF_LOG]))
 		{
 			MakeSysLogDirPath(service, dir);
 
@@ -1275,67 +2505,125 @@ static void NewEditSaveCb(UNUSED Fl_Widget* w, void* data)
 							"Do you want to create the directory?", "No",
 							"Yes, create it", 0, dir.c_str()))
 				{
-					MakeDir(dir.c_str(), showError);
+					AddDirToMake(dirs, dir);
 				}
 			}
 
-			MakeLogRunPath(service, path);
-			MakeLogDirPath(service, dir);
-
-			if (!DirAccessOk(dir.c_str(), not showError))
+			if (!DirAccessOk(logDir.c_str(), not showError))
 			{
-				MakeDir(dir.c_str(), showError);
+				AddDirToMake(dirs, logDir);
 			}
 
-			MESSAGE_DBG("SAVE LOG, SERVICE: %s", service);
-			tbuf[TBUF_LOG]->savefile(path.c_str());
-			FileToExecutableMode(path.c_str());
+			saves.push_back({TBUF_LOG, path, true});
 		}
-		else if (DirAccessOk(dir.c_str(), not showError) && IsEmptyTextBuffer(tbuf[TBUF_LOG]))
+		else if (FileAccessOk(path.c_str(), not showError) && TextStateEmpty(tstate[TBUF_LOG]))
 		{
-			MakeLogRunPath(service, path);
-			tbuf[TBUF_LOG]->savefile(path.c_str());
-			recentlyDeletedLogDir = AskAndDeleteDir(dir, path);
+			emptied.push_back({TBUF_LOG, path, true});
 		}
 
 		MakeLogConfPath(service, path);
 
-		if (!IsEmptyTextBuffer(tbuf[TBUF_LOG_CONF]) && IfNotEqualHash(tbuf[TBUF_LOG_CONF],
-					saveNewEditData->hash[TBUF_LOG_CONF]))
+		if (!saveNewEditData->loaded[TBUF_LOG_CONF])
 		{
-			MakeLogDirPath(service, dir);
-
-			if (!DirAccessOk(dir.c_str(), not showError))
+			// Never shown, the file is as it was.
+		}
+		else if (!TextStateEmpty(tstate[TBUF_LOG_CONF]) && TextStateDirty(tstate[TBUF_LOG_CONF]))
+		{
+			if (!DirAccessOk(logDir.c_str(), not showError))
 			{
-				if (recentlyDeletedLogDir)
-				{
-					fl_alert("You have just deleted directory '%s',\n"
-							"it will be recreated to save the file: '%s'\n"
-							"because it is not empty.",
-							dir.c_str(), path.c_str());
-				}
-
-				MESSAGE_DBG("MAKE DIR LOG AGAIN, SERVICE: %s", service);
-				MakeDir(dir.c_str(), showError);
+				AddDirToMake(dirs, logDir);
 			}
 
-			MESSAGE_DBG("SAVE LOG CONF, SERVICE: %s", service);
-			tbuf[TBUF_LOG_CONF]->savefile(path.c_str());
+			saves.push_back({TBUF_LOG_CONF, path, false});
 		}
-		else if (FileAccessOk(path.c_str(), not showError) && IsEmptyTextBuffer(tbuf[TBUF_LOG_CONF]))
+		else if (FileAccessOk(path.c_str(), not showError) && TextStateEmpty(tstate[TBUF_LOG_CONF]))
 		{
-			tbuf[TBUF_LOG_CONF]->savefile(path.c_str());
-			AskAndDeleteFile(path);
+			emptied.push_back({TBUF_LOG_CONF, path, false});
 		}
 
 		MakeServiceFinishPath(service, path);
-		NewEditSaveCb_Common(TBUF_FINISH, path, saveNewEditData);
+		NewEditSaveCb_Common(TBUF_FINISH, path, saveNewEditData, saves, emptied);
 
 		MakeServiceConfPath(service, path);
-		NewEditSaveCb_Common(TBUF_CONF, path, saveNewEditData);
+		NewEditSaveCb_Common(TBUF_CONF, path, saveNewEditData, saves, emptied);
 
 		MakeServiceCheckPath(service, path);
-		NewEditSaveCb_Common(TBUF_CHECK, path, saveNewEditData);
+		NewEditSaveCb_Common(TBUF_CHECK, path, saveNewEditData, saves, emptied);
+	}
+
+	std::vector<std::string> created;
+	SaveBatch batch;
+
+	SaveBatchInit(batch);
+
+	for (std::string const& made : dirs)
+	{
+		if (!MakeDir(made.c_str(), showError))
+		{
+			batch.failed = true;
+			break;
+		}
+
+		created.push_back(made);
+	}
+
+	for (EditSaveFile const& save : saves)
+	{
+		MESSAGE_DBG("SAVE %s", save.path.c_str());
+		EditSaveAdd(batch, save.id, save.path, save.executable);
+	}
+
+	// On failure the window stays open with the edits, the save can be tried again.
+	if (!SaveBatchCommit(batch))
+	{
+		// A file already in place is kept, with the directory holding it.
+		if (batch.replaced == 0)
+		{
+			for (auto it = created.rbegin(); it != created.rend(); ++it)
+			{
+				RemoveRecursive(it->c_str());
+			}
+		}
+
+		return;
+	}
+
+	// The log directory goes whole only if the saved log conf is not in it.
+	bool logConfSaved = false;
+	bool logDirDeleted = false;
+
+	for (EditSaveFile const& save : saves)
+	{
+		logConfSaved = logConfSaved || (save.id == TBUF_LOG_CONF);
+	}
+
+	for (EditSaveFile const& empty : emptied)
+	{
+		bool deleted;
+
+		if (empty.id == TBUF_LOG_CONF && logDirDeleted)
+		{
+			continue;
+		}
+
+		if (empty.id == TBUF_LOG && !logConfSaved)
+		{
+			deleted = logDirDeleted = AskAndDeleteDir(logDir, empty.path);
+		}
+		else
+		{
+			deleted = AskAndDeleteFile(empty.path);
+		}
+
+		if (!deleted)
+		{
+			EditSaveAdd(batch, empty.id, empty.path, empty.executable);
+		}
+	}
+
+	if (!SaveBatchCommit(batch))
+	{
+		return;
 	}
 
 	((Fl_Double_Window*)saveNewEditData->data)->hide();
@@ -1384,6 +2672,28 @@ static void ChangeState_EnabledDisabledButtons(std::string const& service,
 }
 
 
+/* Asks before losing the edits of the tabs. */
+static void EditCloseCb(UNUSED Fl_Widget* w, void* data)
+{
+	struct NewEditData* saveNewEditData = (struct NewEditData*)data;
+
+	bool dirty = false;
+
+	for (int id = 0; id < TBUF_MAX && !dirty; ++id)
+	{
+		dirty = saveNewEditData->loaded[id] && TextStateDirty(tstate[id]);
+	}
+
+	if (dirty && !fl_choice("There are unsaved changes.\n\n"
+				"Do you want to close without saving them?", "No", "Yes, close", 0))
+	{
+		return;
+	}
+
+	((Fl_Double_Window*)saveNewEditData->data)->hide();
+}
+
+
 void EditNewCb(Fl_Widget* w, void* data)
 {
 	ASSERT_DBG(data);
@@ -1442,12 +2752,18 @@ void EditNewCb(Fl_Widget* w, void* data)
 	tbuf[TBUF_CONF] = new Fl_Text_Buffer();
 	tbuf[TBUF_CHECK] = new Fl_Text_Buffer();
 
-	saveNewEditData.hash[TBUF_SERV] = 0;
-	saveNewEditData.hash[TBUF_LOG] = 0;
-	saveNewEditData.hash[TBUF_LOG_CONF] = 0;
-	saveNewEditData.hash[TBUF_FINISH] = 0;
-	saveNewEditData.hash[TBUF_CONF] = 0;
-	saveNewEditData.hash[TBUF_CHECK] = 0;
+	for (int i = 0; i < TBUF_MAX; ++i)
+	{
+		TextStateAttach(tstate[i], tbuf[i]);
+
+		// A new service has nothing to read.
+		saveNewEditData.loaded[i] = (id == NEW);
+
+		if (id == NEW)
+		{
+			TextStateReset(tstate[i]);
+		}
+	}
 
 	Fl_Tabs* tabs = new Fl_Tabs(15, 50, 475, 265);
 	tabs->selection_color((Fl_Color)LBL_TAB_COLOR);
@@ -1608,7 +2924,8 @@ void EditNewCb(Fl_Widget* w, void* data)
 	btn[CANCEL] = new Fl_Button(310 + BTN_W + 2, 355 - BTN_H, BTN_W, BTN_H, "Close");
 
 	btn[SAVE]->callback(NewEditSaveCb, (void*)&saveNewEditData);
-	btn[CANCEL]->callback(CloseWindowCb, (void*)wnd);
+	btn[CANCEL]->callback(EditCloseCb, (void*)&saveNewEditData);
+	wnd->callback(EditCloseCb, (void*)&saveNewEditData);
 
 	btn[DELETE_SRV]->image(get_icon_warning());
 	btn[DELETE_LOG]->image(get_icon_warning());
@@ -1647,6 +2964,12 @@ void EditNewCb(Fl_Widget* w, void* data)
 		saveNewEditData.label[LBL_CONF] = lblConf;
 		saveNewEditData.label[LBL_CHECK] = lblCheck;
 
+		saveNewEditData.tabs = tabs;
+		saveNewEditData.tabLog = tabLog;
+
+		tabs->callback(EditTabCb, (void*)&saveNewEditData);
+		tabLog->callback(EditTabCb, (void*)&saveNewEditData);
+
 		ChangeState_EnabledDisabledButtons(service, &saveNewEditData);
 
 		EditLoad(&saveNewEditData);
@@ -1667,6 +2990,12 @@ void EditNewCb(Fl_Widget* w, void* data)
 	delete tedt[TEDT_FINISH];
 	delete tedt[TEDT_CONF];
 	delete tedt[TEDT_CHECK];
+
+	for (int i = 0; i < TBUF_MAX; ++i)
+	{
+		TextStateDetach(tstate[i]);
+	}
+
 	delete tbuf[TBUF_SERV];
 	delete tbuf[TBUF_LOG];
 	delete tbuf[TBUF_LOG_CONF];